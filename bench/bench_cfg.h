@@ -0,0 +1,34 @@
+/**
+ * @file bench_cfg.h
+ * @author agent
+ * @brief c reflection benchmark config
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#ifndef __BENCH_CFG_H__
+#define __BENCH_CFG_H__
+
+#include "stddef.h"
+
+/**
+ * @brief 统计分配次数的内存分配函数
+ *
+ * @param size 大小
+ * @return void* 内存地址
+ */
+void *benchMalloc(size_t size);
+
+/**
+ * @brief 统计释放次数的内存释放函数
+ *
+ * @param ptr 内存地址
+ */
+void benchFree(void *ptr);
+
+#define REFLECT_MALLOC          benchMalloc
+#define REFLECT_FREE            benchFree
+
+#endif
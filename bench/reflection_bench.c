@@ -0,0 +1,801 @@
+/**
+ * @file reflection_bench.c
+ * @author agent
+ * @brief c reflection benchmark
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "reflection.h"
+#include "obj_list.h"
+#include "cerializable.h"
+#include "cjsonable.h"
+#include "stdio.h"
+#include "string.h"
+#include "stdint.h"
+#include "time.h"
+
+
+#define BENCH_BATCH_SIZE            64          /**< 需要单独计时的操作每批处理的对象数量 */
+#define BENCH_MIN_TIME_MS           200         /**< 每项测试的默认最短运行时间 */
+#define BENCH_MAX_ITERATIONS        100000000   /**< 每项测试的最大迭代次数 */
+
+#define BENCH_DEEP_DEPTH            32          /**< 嵌套测试的深度 */
+#define BENCH_LIST_SIZE             256         /**< 链表测试的元素数量 */
+#define BENCH_ARRAY_SIZE            256         /**< 数组测试的元素数量 */
+#define BENCH_OBJ_LIST_SIZE         256         /**< objListAdd，objListHeadAdd 测试每次添加的节点数量，两者相同便于对比 */
+
+
+/**
+ * @brief 宽结构体，只包含基础类型字段
+ *
+ */
+typedef struct
+{
+    int i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15;
+    double d0, d1, d2, d3, d4, d5, d6, d7;
+    long l0, l1, l2, l3, l4, l5, l6, l7;
+} BenchWide;
+
+Reflection benchWideReflection[] =
+{
+    REFLECT_MODEL_INT(BenchWide, i0),
+    REFLECT_MODEL_INT(BenchWide, i1),
+    REFLECT_MODEL_INT(BenchWide, i2),
+    REFLECT_MODEL_INT(BenchWide, i3),
+    REFLECT_MODEL_INT(BenchWide, i4),
+    REFLECT_MODEL_INT(BenchWide, i5),
+    REFLECT_MODEL_INT(BenchWide, i6),
+    REFLECT_MODEL_INT(BenchWide, i7),
+    REFLECT_MODEL_INT(BenchWide, i8),
+    REFLECT_MODEL_INT(BenchWide, i9),
+    REFLECT_MODEL_INT(BenchWide, i10),
+    REFLECT_MODEL_INT(BenchWide, i11),
+    REFLECT_MODEL_INT(BenchWide, i12),
+    REFLECT_MODEL_INT(BenchWide, i13),
+    REFLECT_MODEL_INT(BenchWide, i14),
+    REFLECT_MODEL_INT(BenchWide, i15),
+    REFLECT_MODEL_DOUBLE(BenchWide, d0),
+    REFLECT_MODEL_DOUBLE(BenchWide, d1),
+    REFLECT_MODEL_DOUBLE(BenchWide, d2),
+    REFLECT_MODEL_DOUBLE(BenchWide, d3),
+    REFLECT_MODEL_DOUBLE(BenchWide, d4),
+    REFLECT_MODEL_DOUBLE(BenchWide, d5),
+    REFLECT_MODEL_DOUBLE(BenchWide, d6),
+    REFLECT_MODEL_DOUBLE(BenchWide, d7),
+    REFLECT_MODEL_LONG(BenchWide, l0),
+    REFLECT_MODEL_LONG(BenchWide, l1),
+    REFLECT_MODEL_LONG(BenchWide, l2),
+    REFLECT_MODEL_LONG(BenchWide, l3),
+    REFLECT_MODEL_LONG(BenchWide, l4),
+    REFLECT_MODEL_LONG(BenchWide, l5),
+    REFLECT_MODEL_LONG(BenchWide, l6),
+    REFLECT_MODEL_LONG(BenchWide, l7),
+    REFLECT_MODEL_OBJ(BenchWide),
+};
+
+/**
+ * @brief 深层嵌套的节点
+ *
+ */
+typedef struct bench_node
+{
+    int depth;
+    char *tag;
+    struct bench_node *child;
+} BenchNode;
+
+Reflection benchNodeReflection[] =
+{
+    REFLECT_MODEL_INT(BenchNode, depth),
+    REFLECT_MODEL_STRING(BenchNode, tag),
+    REFLECT_MODEL_STRUCT_P(BenchNode, child, benchNodeReflection),
+    REFLECT_MODEL_OBJ(BenchNode),
+};
+
+/**
+ * @brief 链表元素
+ *
+ */
+typedef struct
+{
+    int id;
+    double score;
+    char *label;
+} BenchRecord;
+
+Reflection benchRecordReflection[] =
+{
+    REFLECT_MODEL_INT(BenchRecord, id),
+    REFLECT_MODEL_DOUBLE(BenchRecord, score),
+    REFLECT_MODEL_STRING(BenchRecord, label),
+    REFLECT_MODEL_OBJ(BenchRecord),
+};
+
+/**
+ * @brief 长链表
+ *
+ */
+typedef struct
+{
+    int id;
+    ObjList *records;
+} BenchFeed;
+
+Reflection benchFeedReflection[] =
+{
+    REFLECT_MODEL_INT(BenchFeed, id),
+    REFLECT_MODEL_LIST(BenchFeed, records, benchRecordReflection),
+    REFLECT_MODEL_OBJ(BenchFeed),
+};
+
+/**
+ * @brief 字符串为主的结构体
+ *
+ */
+typedef struct
+{
+    char *s0, *s1, *s2, *s3, *s4, *s5, *s6, *s7;
+    char *s8, *s9, *s10, *s11, *s12, *s13, *s14, *s15;
+} BenchText;
+
+Reflection benchTextReflection[] =
+{
+    REFLECT_MODEL_STRING(BenchText, s0),
+    REFLECT_MODEL_STRING(BenchText, s1),
+    REFLECT_MODEL_STRING(BenchText, s2),
+    REFLECT_MODEL_STRING(BenchText, s3),
+    REFLECT_MODEL_STRING(BenchText, s4),
+    REFLECT_MODEL_STRING(BenchText, s5),
+    REFLECT_MODEL_STRING(BenchText, s6),
+    REFLECT_MODEL_STRING(BenchText, s7),
+    REFLECT_MODEL_STRING(BenchText, s8),
+    REFLECT_MODEL_STRING(BenchText, s9),
+    REFLECT_MODEL_STRING(BenchText, s10),
+    REFLECT_MODEL_STRING(BenchText, s11),
+    REFLECT_MODEL_STRING(BenchText, s12),
+    REFLECT_MODEL_STRING(BenchText, s13),
+    REFLECT_MODEL_STRING(BenchText, s14),
+    REFLECT_MODEL_STRING(BenchText, s15),
+    REFLECT_MODEL_OBJ(BenchText),
+};
+
+/**
+ * @brief 数组为主的结构体
+ *
+ */
+typedef struct
+{
+    int ids[BENCH_ARRAY_SIZE];
+    double values[BENCH_ARRAY_SIZE];
+} BenchSamples;
+
+Reflection benchSamplesReflection[] =
+{
+    REFLECT_MODEL_ARRAY(BenchSamples, ids, BENCH_ARRAY_SIZE, REFLECT_BASIC_MODEL_INT),
+    REFLECT_MODEL_ARRAY(BenchSamples, values, BENCH_ARRAY_SIZE, REFLECT_BASIC_MODEL_DOUBLE),
+    REFLECT_MODEL_OBJ(BenchSamples),
+};
+
+/**
+ * @brief 非整数浮点数为主的结构体
+ *
+ */
+typedef struct
+{
+    float levels[BENCH_ARRAY_SIZE];
+    double readings[BENCH_ARRAY_SIZE];
+} BenchReadings;
+
+Reflection benchReadingsReflection[] =
+{
+    REFLECT_MODEL_ARRAY(BenchReadings, levels, BENCH_ARRAY_SIZE, REFLECT_BASIC_MODEL_FLOAT),
+    REFLECT_MODEL_ARRAY(BenchReadings, readings, BENCH_ARRAY_SIZE, REFLECT_BASIC_MODEL_DOUBLE),
+    REFLECT_MODEL_OBJ(BenchReadings),
+};
+
+
+/**
+ * @brief 测试数据
+ *
+ */
+typedef struct
+{
+    const char *name;                           /**< 名称 */
+    Reflection *model;                          /**< 模型 */
+    void *obj;                                  /**< 对象 */
+    void *mem;                                  /**< 序列化数据 */
+    size_t memSize;                             /**< 序列化数据大小 */
+    char *json;                                 /**< JSON 文本 */
+    size_t jsonSize;                            /**< JSON 文本长度 */
+} BenchShape;
+
+/**
+ * @brief 计时统计
+ *
+ */
+typedef struct
+{
+    uint64_t ns;                                /**< 计时部分的总时间 */
+    size_t allocs;                              /**< 计时部分的分配次数 */
+    size_t frees;                               /**< 计时部分的释放次数 */
+    uint64_t start;                             /**< 本段计时的开始时间 */
+    size_t startAllocs;                         /**< 本段计时开始时的分配次数 */
+    size_t startFrees;                          /**< 本段计时开始时的释放次数 */
+} BenchStat;
+
+/**
+ * @brief 测试操作
+ *
+ * @param shape 测试数据
+ * @param iterations 迭代次数
+ * @param stat 计时统计
+ * @return size_t 每次操作处理的数据大小
+ */
+typedef size_t (*BenchOp)(BenchShape *shape, size_t iterations, BenchStat *stat);
+
+/**
+ * @brief 测试项
+ *
+ */
+typedef struct
+{
+    const char *op;                             /**< 操作名称 */
+    BenchOp func;                               /**< 操作函数 */
+} BenchCase;
+
+/**
+ * @brief 输出格式
+ *
+ */
+typedef enum
+{
+    BENCH_FORMAT_TEXT = 0,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON,
+} BenchFormat;
+
+
+static size_t benchAllocCount = 0;
+static size_t benchFreeCount = 0;
+
+
+void *benchMalloc(size_t size)
+{
+    benchAllocCount++;
+    return malloc(size);
+}
+
+
+void benchFree(void *ptr)
+{
+    if (ptr)
+    {
+        benchFreeCount++;
+    }
+    free(ptr);
+}
+
+
+/**
+ * @brief 获取单调时间
+ *
+ * @return uint64_t 时间(ns)
+ */
+static uint64_t benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief 开始计时
+ *
+ * @param stat 计时统计
+ */
+static void benchStart(BenchStat *stat)
+{
+    stat->startAllocs = benchAllocCount;
+    stat->startFrees = benchFreeCount;
+    stat->start = benchNow();
+}
+
+
+/**
+ * @brief 结束计时
+ *
+ * @param stat 计时统计
+ */
+static void benchStop(BenchStat *stat)
+{
+    stat->ns += benchNow() - stat->start;
+    stat->allocs += benchAllocCount - stat->startAllocs;
+    stat->frees += benchFreeCount - stat->startFrees;
+}
+
+
+/**
+ * @brief 生成测试字符串
+ *
+ * @param len 长度
+ * @param seed 内容种子
+ * @return char* 字符串
+ */
+static char *benchString(size_t len, int seed)
+{
+    char *str = REFLECT_MALLOC(len + 1);
+    for (size_t i = 0; i < len; i++)
+    {
+        str[i] = 'a' + (char)((i * 7 + seed) % 26);
+    }
+    str[len] = '\0';
+    return str;
+}
+
+
+static void *benchNewWide(void)
+{
+    BenchWide *wide = REFLECT_MALLOC(sizeof(BenchWide));
+    int *ints = &wide->i0;
+    double *doubles = &wide->d0;
+    long *longs = &wide->l0;
+    for (int i = 0; i < 16; i++)
+    {
+        ints[i] = i * 1000003 - 7;
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        doubles[i] = i * 3.14159 + 0.1;
+        longs[i] = (long)i * 1000000007L;
+    }
+    return wide;
+}
+
+
+static void *benchNewDeep(void)
+{
+    BenchNode *root = NULL;
+    for (int i = BENCH_DEEP_DEPTH - 1; i >= 0; i--)
+    {
+        BenchNode *node = REFLECT_MALLOC(sizeof(BenchNode));
+        node->depth = i;
+        node->tag = benchString(8, i);
+        node->child = root;
+        root = node;
+    }
+    return root;
+}
+
+
+static void *benchNewFeed(void)
+{
+    BenchFeed *feed = REFLECT_MALLOC(sizeof(BenchFeed));
+    ObjListHead records = {0};
+    feed->id = 1;
+    for (int i = 0; i < BENCH_LIST_SIZE; i++)
+    {
+        BenchRecord *record = REFLECT_MALLOC(sizeof(BenchRecord));
+        record->id = i;
+        record->score = i * 0.75;
+        record->label = benchString(12, i);
+        objListHeadAdd(&records, record);
+    }
+    feed->records = records.head;
+    return feed;
+}
+
+
+static void *benchNewText(void)
+{
+    BenchText *text = REFLECT_MALLOC(sizeof(BenchText));
+    char **strs = &text->s0;
+    for (int i = 0; i < 16; i++)
+    {
+        strs[i] = benchString((size_t)8 << (i % 6), i);
+    }
+    return text;
+}
+
+
+static void *benchNewSamples(void)
+{
+    BenchSamples *samples = REFLECT_MALLOC(sizeof(BenchSamples));
+    for (int i = 0; i < BENCH_ARRAY_SIZE; i++)
+    {
+        samples->ids[i] = i * 31;
+        samples->values[i] = i / 7.0;
+    }
+    return samples;
+}
+
+
+static void *benchNewReadings(void)
+{
+    BenchReadings *readings = REFLECT_MALLOC(sizeof(BenchReadings));
+    for (int i = 0; i < BENCH_ARRAY_SIZE; i++)
+    {
+        readings->levels[i] = i * 0.37f - 40.5f;
+        /* 一半数值需要科学计数法 */
+        readings->readings[i] = (i % 2 ? 1e-7 : 1e5) * (i + 0.1) / 3.0;
+    }
+    return readings;
+}
+
+
+static size_t benchSerialize(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    size_t size;
+    benchStart(stat);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        REFLECT_FREE(cSerialize(shape->obj, shape->model, &size));
+    }
+    benchStop(stat);
+    return shape->memSize;
+}
+
+
+static size_t benchDeserialize(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    void *objs[BENCH_BATCH_SIZE];
+    for (size_t i = 0; i < iterations; i += BENCH_BATCH_SIZE)
+    {
+        size_t count = iterations - i < BENCH_BATCH_SIZE ? iterations - i : BENCH_BATCH_SIZE;
+        benchStart(stat);
+        for (size_t j = 0; j < count; j++)
+        {
+            objs[j] = cDeserialize(shape->mem, shape->model);
+        }
+        benchStop(stat);
+        for (size_t j = 0; j < count; j++)
+        {
+            reflectFreeObj(objs[j], shape->model);
+        }
+    }
+    return shape->memSize;
+}
+
+
+static size_t benchFreeObj(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    void *objs[BENCH_BATCH_SIZE];
+    for (size_t i = 0; i < iterations; i += BENCH_BATCH_SIZE)
+    {
+        size_t count = iterations - i < BENCH_BATCH_SIZE ? iterations - i : BENCH_BATCH_SIZE;
+        for (size_t j = 0; j < count; j++)
+        {
+            objs[j] = cDeserialize(shape->mem, shape->model);
+        }
+        benchStart(stat);
+        for (size_t j = 0; j < count; j++)
+        {
+            reflectFreeObj(objs[j], shape->model);
+        }
+        benchStop(stat);
+    }
+    return shape->memSize;
+}
+
+
+static size_t benchJsonEncode(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    CJsonBuffer buffer = {0};
+    benchStart(stat);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        buffer.used = 0;
+        cJsonEncode(shape->obj, shape->model, &buffer);
+    }
+    benchStop(stat);
+    cJsonBufferFree(&buffer);
+    return shape->jsonSize;
+}
+
+
+static size_t benchJsonDecode(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    void *objs[BENCH_BATCH_SIZE];
+    for (size_t i = 0; i < iterations; i += BENCH_BATCH_SIZE)
+    {
+        size_t count = iterations - i < BENCH_BATCH_SIZE ? iterations - i : BENCH_BATCH_SIZE;
+        benchStart(stat);
+        for (size_t j = 0; j < count; j++)
+        {
+            objs[j] = cJsonDecode(shape->json, shape->jsonSize, shape->model, NULL);
+        }
+        benchStop(stat);
+        for (size_t j = 0; j < count; j++)
+        {
+            reflectFreeObj(objs[j], shape->model);
+        }
+    }
+    return shape->jsonSize;
+}
+
+
+static void benchFreeList(ObjList *list)
+{
+    while (list)
+    {
+        ObjList *next = list->next;
+        objListNodeFree(list);
+        list = next;
+    }
+}
+
+
+static size_t benchObjListAdd(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    (void)shape;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        ObjList *list = NULL;
+        benchStart(stat);
+        for (size_t j = 0; j < BENCH_OBJ_LIST_SIZE; j++)
+        {
+            list = objListAdd(list, (void *)(j + 1));
+        }
+        benchStop(stat);
+        benchFreeList(list);
+    }
+    return 0;
+}
+
+
+static size_t benchObjListHeadAdd(BenchShape *shape, size_t iterations, BenchStat *stat)
+{
+    (void)shape;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        ObjListHead list = {0};
+        benchStart(stat);
+        for (size_t j = 0; j < BENCH_OBJ_LIST_SIZE; j++)
+        {
+            objListHeadAdd(&list, (void *)(j + 1));
+        }
+        benchStop(stat);
+        benchFreeList(list.head);
+    }
+    return 0;
+}
+
+
+static BenchCase benchCodecCases[] =
+{
+    {"serialize", benchSerialize},
+    {"deserialize", benchDeserialize},
+    {"free", benchFreeObj},
+    {"json_encode", benchJsonEncode},
+    {"json_decode", benchJsonDecode},
+};
+
+static BenchCase benchListCases[] =
+{
+    {"objListAdd", benchObjListAdd},
+    {"objListHeadAdd", benchObjListHeadAdd},
+};
+
+
+/**
+ * @brief 初始化测试数据
+ *
+ * @param shape 测试数据
+ * @param name 名称
+ * @param model 模型
+ * @param obj 对象
+ */
+static void benchShapeInit(BenchShape *shape, const char *name, Reflection *model, void *obj)
+{
+    shape->name = name;
+    shape->model = model;
+    shape->obj = obj;
+    shape->mem = obj ? cSerialize(obj, model, &shape->memSize) : NULL;
+    shape->json = obj ? cJsonStringify(obj, model, &shape->jsonSize) : NULL;
+}
+
+
+/**
+ * @brief 释放测试数据
+ *
+ * @param shape 测试数据
+ */
+static void benchShapeDeinit(BenchShape *shape)
+{
+    if (shape->obj)
+    {
+        reflectFreeObj(shape->obj, shape->model);
+        REFLECT_FREE(shape->mem);
+        REFLECT_FREE(shape->json);
+    }
+}
+
+
+/**
+ * @brief 运行测试项
+ *        迭代次数从1开始增加，直到运行时间不小于 minTime
+ *
+ * @param shape 测试数据
+ * @param benchCase 测试项
+ * @param minTime 最短运行时间(ns)
+ * @param format 输出格式
+ * @param first 是否为第一条结果
+ */
+static void benchRun(BenchShape *shape, BenchCase *benchCase, uint64_t minTime,
+                     BenchFormat format, int first)
+{
+    size_t iterations = 1;
+    size_t bytes;
+    BenchStat stat;
+    while (1)
+    {
+        memset(&stat, 0, sizeof(stat));
+        bytes = benchCase->func(shape, iterations, &stat);
+        if (stat.ns >= minTime || iterations >= BENCH_MAX_ITERATIONS)
+        {
+            break;
+        }
+        double scale = stat.ns ? (double)minTime * 1.2 / stat.ns : 100;
+        scale = scale > 100 ? 100 : (scale < 2 ? 2 : scale);
+        iterations = (size_t)(iterations * scale);
+        iterations = iterations > BENCH_MAX_ITERATIONS ? BENCH_MAX_ITERATIONS : iterations;
+    }
+
+    double nsPerOp = (double)stat.ns / iterations;
+    double allocsPerOp = (double)stat.allocs / iterations;
+    double freesPerOp = (double)stat.frees / iterations;
+    double mbPerSec = stat.ns ? (double)bytes * iterations * 1000.0 / stat.ns : 0;
+
+    switch (format)
+    {
+    case BENCH_FORMAT_CSV:
+        printf("%s,%s,%zu,%.1f,%zu,%.2f,%.2f,%.1f\n",
+               shape->name, benchCase->op, iterations, nsPerOp, bytes,
+               allocsPerOp, freesPerOp, mbPerSec);
+        break;
+    case BENCH_FORMAT_JSON:
+        printf("%s\n  {\"shape\":\"%s\",\"op\":\"%s\",\"iterations\":%zu,\"ns_per_op\":%.1f,"
+               "\"bytes_per_op\":%zu,\"allocs_per_op\":%.2f,\"frees_per_op\":%.2f,\"mb_per_s\":%.1f}",
+               first ? "" : ",", shape->name, benchCase->op, iterations, nsPerOp, bytes,
+               allocsPerOp, freesPerOp, mbPerSec);
+        break;
+    default:
+        printf("%-8s %-16s %12zu %14.1f %10zu %10.2f %10.2f %10.1f\n",
+               shape->name, benchCase->op, iterations, nsPerOp, bytes,
+               allocsPerOp, freesPerOp, mbPerSec);
+        break;
+    }
+    fflush(stdout);
+}
+
+
+/**
+ * @brief 判断测试项是否被选中
+ *
+ * @param filter 过滤字符串，匹配 "shape/op" 的子串，NULL表示全部
+ * @param shape 测试数据名称
+ * @param op 操作名称
+ * @return int 1 选中 0 未选中
+ */
+static int benchSelected(const char *filter, const char *shape, const char *op)
+{
+    char name[64];
+    if (!filter)
+    {
+        return 1;
+    }
+    snprintf(name, sizeof(name), "%s/%s", shape, op);
+    return strstr(name, filter) != NULL;
+}
+
+
+static void benchUsage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [-f text|csv|json] [-t ms] [-s filter]\n"
+            "  -f  output format, default text\n"
+            "  -t  minimum run time per case in milliseconds, default %d\n"
+            "  -s  only run cases whose \"shape/op\" contains filter\n",
+            program, BENCH_MIN_TIME_MS);
+}
+
+
+int main(int argc, char *argv[])
+{
+    BenchFormat format = BENCH_FORMAT_TEXT;
+    uint64_t minTime = (uint64_t)BENCH_MIN_TIME_MS * 1000000ULL;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "csv") == 0)
+            {
+                format = BENCH_FORMAT_CSV;
+            }
+            else if (strcmp(argv[i], "json") == 0)
+            {
+                format = BENCH_FORMAT_JSON;
+            }
+            else if (strcmp(argv[i], "text") != 0)
+            {
+                benchUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            minTime = strtoull(argv[++i], NULL, 10) * 1000000ULL;
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            benchUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    BenchShape shapes[6];
+    BenchShape listShape;
+    benchShapeInit(&shapes[0], "wide", benchWideReflection, benchNewWide());
+    benchShapeInit(&shapes[1], "deep", benchNodeReflection, benchNewDeep());
+    benchShapeInit(&shapes[2], "list", benchFeedReflection, benchNewFeed());
+    benchShapeInit(&shapes[3], "text", benchTextReflection, benchNewText());
+    benchShapeInit(&shapes[4], "array", benchSamplesReflection, benchNewSamples());
+    benchShapeInit(&shapes[5], "float", benchReadingsReflection, benchNewReadings());
+    benchShapeInit(&listShape, "objlist", NULL, NULL);
+
+    switch (format)
+    {
+    case BENCH_FORMAT_CSV:
+        printf("shape,op,iterations,ns_per_op,bytes_per_op,allocs_per_op,frees_per_op,mb_per_s\n");
+        break;
+    case BENCH_FORMAT_JSON:
+        printf("[");
+        break;
+    default:
+        printf("%-8s %-16s %12s %14s %10s %10s %10s %10s\n",
+               "shape", "op", "iterations", "ns/op", "bytes/op", "allocs/op", "frees/op", "MB/s");
+        break;
+    }
+
+    int first = 1;
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++)
+    {
+        for (size_t j = 0; j < sizeof(benchCodecCases) / sizeof(benchCodecCases[0]); j++)
+        {
+            if (benchSelected(filter, shapes[i].name, benchCodecCases[j].op))
+            {
+                benchRun(&shapes[i], &benchCodecCases[j], minTime, format, first);
+                first = 0;
+            }
+        }
+    }
+    for (size_t j = 0; j < sizeof(benchListCases) / sizeof(benchListCases[0]); j++)
+    {
+        if (benchSelected(filter, listShape.name, benchListCases[j].op))
+        {
+            benchRun(&listShape, &benchListCases[j], minTime, format, first);
+            first = 0;
+        }
+    }
+
+    if (format == BENCH_FORMAT_JSON)
+    {
+        printf("\n]\n");
+    }
+
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++)
+    {
+        benchShapeDeinit(&shapes[i]);
+    }
+    return 0;
+}
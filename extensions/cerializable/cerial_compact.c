@@ -0,0 +1,601 @@
+/**
+ * @file cerial_compact.c
+ * @author agent
+ * @brief c serializable compact format
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "cerializable.h"
+#include "cerial_internal.h"
+#include "string.h"
+#include "limits.h"
+#include "obj_list.h"
+
+
+#define CERIAL_COMPACT_MIN_SIZE     256
+
+
+/**
+ * @brief 紧凑格式写入空间预留
+ *
+ * @param writer 写入器
+ * @param size 需要的空间大小
+ * @return unsigned char* 写入地址，失败返回NULL
+ */
+static unsigned char *cCompactReserve(CCompactWriter *writer, size_t size)
+{
+    CSerialBuffer *buffer = writer->buffer;
+    if (writer->result != CERIAL_OK)
+    {
+        return NULL;
+    }
+    if (buffer->used + size > buffer->size)
+    {
+        size_t newSize = buffer->size ? buffer->size * 2 : CERIAL_COMPACT_MIN_SIZE;
+        while (newSize < buffer->used + size)
+        {
+            newSize *= 2;
+        }
+        void *mem = REFLECT_MALLOC(newSize);
+        if (!mem)
+        {
+            writer->result = CERIAL_ERROR_NO_MEMORY;
+            return NULL;
+        }
+        if (buffer->mem)
+        {
+            memcpy(mem, buffer->mem, buffer->used);
+            REFLECT_FREE(buffer->mem);
+        }
+        buffer->mem = mem;
+        buffer->size = newSize;
+    }
+    return (unsigned char *)buffer->mem + buffer->used;
+}
+
+
+/**
+ * @brief 紧凑格式写入数据
+ *
+ * @param writer 写入器
+ * @param data 数据
+ * @param size 数据大小
+ */
+void cCompactPutData(CCompactWriter *writer, const void *data, size_t size)
+{
+    unsigned char *p = cCompactReserve(writer, size);
+    REFLECT_ASSERT(p, return);
+    if (size)
+    {
+        memcpy(p, data, size);
+    }
+    writer->buffer->used += size;
+}
+
+
+/**
+ * @brief 紧凑格式写入无符号变长整数(LEB128)
+ *
+ * @param writer 写入器
+ * @param value 数值
+ */
+void cCompactPutVarint(CCompactWriter *writer, uint64_t value)
+{
+    unsigned char *p = cCompactReserve(writer, 10);
+    REFLECT_ASSERT(p, return);
+    size_t len = 0;
+    while (value >= 0x80)
+    {
+        p[len++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    p[len++] = (unsigned char)value;
+    writer->buffer->used += len;
+}
+
+
+/**
+ * @brief 紧凑格式写入小端定长整数
+ *
+ * @param writer 写入器
+ * @param value 数值
+ * @param size 字节数
+ */
+static void cCompactPutFixed(CCompactWriter *writer, uint64_t value, size_t size)
+{
+    unsigned char *p = cCompactReserve(writer, size);
+    REFLECT_ASSERT(p, return);
+    for (size_t i = 0; i < size; i++)
+    {
+        p[i] = (unsigned char)(value >> (i * 8));
+    }
+    writer->buffer->used += size;
+}
+
+
+/**
+ * @brief 紧凑格式写入可为NULL的对象
+ *        变长整数(0表示NULL, 1表示非NULL)之后写入对象，用于指针字段和链表元素
+ *
+ * @param writer 写入器
+ * @param obj 对象，可为NULL
+ * @param plan 执行计划
+ */
+void cCompactPutRef(CCompactWriter *writer, void *obj, ReflectPlan *plan)
+{
+    cCompactPutVarint(writer, obj ? 1 : 0);
+    if (obj)
+    {
+        cCompactPutObj(writer, obj, plan);
+    }
+}
+
+
+/**
+ * @brief 紧凑格式写入字段
+ *
+ * @param writer 写入器
+ * @param addr 字段地址
+ * @param field 执行计划字段
+ */
+void cCompactPutField(CCompactWriter *writer, void *addr, ReflectPlanField *field)
+{
+    if (field->isPointer)
+    {
+        cCompactPutRef(writer, *(void **)addr, field->plan);
+        return;
+    }
+
+    switch (field->type)
+    {
+    case REFLECT_TYPE_CHAR:
+        cCompactPutData(writer, addr, 1);
+        break;
+    case REFLECT_TYPE_SHORT:
+        cCompactPutVarint(writer, CERIAL_ZIGZAG(*(short *)addr));
+        break;
+    case REFLECT_TYPE_INT:
+        cCompactPutVarint(writer, CERIAL_ZIGZAG(*(int *)addr));
+        break;
+    case REFLECT_TYPE_LONG:
+        cCompactPutVarint(writer, CERIAL_ZIGZAG(*(long *)addr));
+        break;
+    case REFLECT_TYPE_FLOAT:
+    {
+        uint32_t value;
+        memcpy(&value, addr, sizeof(value));
+        cCompactPutFixed(writer, value, sizeof(value));
+        break;
+    }
+    case REFLECT_TYPE_DOUBLE:
+    {
+        uint64_t value;
+        memcpy(&value, addr, sizeof(value));
+        cCompactPutFixed(writer, value, sizeof(value));
+        break;
+    }
+    case REFLECT_TYPE_STRING:
+    {
+        char *str = *(char **)addr;
+        size_t len = str ? strlen(str) : 0;
+        cCompactPutVarint(writer, str ? len + 1 : 0);
+        cCompactPutData(writer, str, len);
+        break;
+    }
+    case REFLECT_TYPE_STRUCT:
+        cCompactPutObj(writer, addr, field->plan);
+        break;
+    case REFLECT_TYPE_ARRAY:
+        for (size_t i = 0; i < field->count; i++)
+        {
+            cCompactPutObj(writer, (void *)((size_t)addr + field->plan->size * i), field->plan);
+        }
+        break;
+    case REFLECT_TYPE_LIST:
+    {
+        ObjList *list = *(ObjList **)addr;
+        cCompactPutVarint(writer, objListGetSize(list));
+        while (list)
+        {
+            cCompactPutRef(writer, list->obj, field->plan);
+            list = list->next;
+        }
+        break;
+    }
+    case REFLECT_TYPE_VECTOR:
+    {
+        char *items = *(char **)addr;
+        size_t count = items ? *(size_t *)((size_t)addr - field->offset + field->countOffset) : 0;
+        cCompactPutVarint(writer, count);
+        for (size_t i = 0; i < count; i++)
+        {
+            cCompactPutObj(writer, items + field->plan->size * i, field->plan);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief 紧凑格式写入对象
+ *        按模型顺序写入所有字段，不写入字段名和对齐填充
+ *
+ * @param writer 写入器
+ * @param obj 对象
+ * @param plan 执行计划
+ */
+void cCompactPutObj(CCompactWriter *writer, void *obj, ReflectPlan *plan)
+{
+    for (size_t i = 0; i < plan->memberCount; i++)
+    {
+        ReflectPlanField *p = &plan->members[i];
+        cCompactPutField(writer, (void *)((size_t)obj + p->offset), p);
+    }
+}
+
+
+/**
+ * @brief 紧凑格式序列化
+ *        数据追加在 buffer->used 之后，空间不足时自动扩展缓冲区
+ *
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeCompact(void *obj, Reflection *model, CSerialBuffer *buffer)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    size_t used = buffer->used;
+    CCompactWriter writer = {buffer, CERIAL_OK};
+    cCompactPutObj(&writer, obj, plan);
+    if (writer.result != CERIAL_OK)
+    {
+        buffer->used = used;
+    }
+    REFLECT_STATS_END(scope, 0, buffer->used - used);
+    return writer.result;
+}
+
+
+/**
+ * @brief 紧凑格式读取数据
+ *
+ * @param reader 读取器
+ * @param size 数据大小
+ * @return const unsigned char* 数据地址，数据不足返回NULL
+ */
+const unsigned char *cCompactGetData(CCompactReader *reader, size_t size)
+{
+    if (reader->result != CERIAL_OK)
+    {
+        return NULL;
+    }
+    if (size > reader->size - reader->used)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return NULL;
+    }
+    const unsigned char *p = reader->data + reader->used;
+    reader->used += size;
+    return p;
+}
+
+
+/**
+ * @brief 紧凑格式读取无符号变长整数(LEB128)
+ *
+ * @param reader 读取器
+ * @return uint64_t 数值，数据无效时返回0
+ */
+uint64_t cCompactGetVarint(CCompactReader *reader)
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+        const unsigned char *p = cCompactGetData(reader, 1);
+        REFLECT_ASSERT(p, return 0);
+        value |= (uint64_t)(*p & 0x7F) << shift;
+        if (!(*p & 0x80))
+        {
+            return value;
+        }
+    }
+    reader->result = CERIAL_ERROR_INVALID;
+    return 0;
+}
+
+
+/**
+ * @brief 紧凑格式读取小端定长整数
+ *
+ * @param reader 读取器
+ * @param size 字节数
+ * @return uint64_t 数值
+ */
+static uint64_t cCompactGetFixed(CCompactReader *reader, size_t size)
+{
+    const unsigned char *p = cCompactGetData(reader, size);
+    REFLECT_ASSERT(p, return 0);
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= (uint64_t)p[i] << (i * 8);
+    }
+    return value;
+}
+
+
+/**
+ * @brief 紧凑格式读取有符号整数，检查数值是否超出字段类型的范围
+ *
+ * @param reader 读取器
+ * @param min 最小值
+ * @param max 最大值
+ * @return int64_t 数值
+ */
+static int64_t cCompactGetInt(CCompactReader *reader, int64_t min, int64_t max)
+{
+    uint64_t data = cCompactGetVarint(reader);
+    int64_t value = CERIAL_UNZIGZAG(data);
+    if (value < min || value > max)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return 0;
+    }
+    return value;
+}
+
+
+/**
+ * @brief 紧凑格式新建对象
+ *
+ * @param reader 读取器
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ * @return void* 对象，失败返回NULL
+ */
+static void *cCompactNewObj(CCompactReader *reader, ReflectPlan *plan, size_t depth)
+{
+    if (reader->result != CERIAL_OK)
+    {
+        return NULL;
+    }
+    void *obj = REFLECT_MALLOC(plan->size);
+    if (!obj)
+    {
+        reader->result = CERIAL_ERROR_NO_MEMORY;
+        return NULL;
+    }
+    memset(obj, 0, plan->size);
+    cCompactGetObj(reader, obj, plan, depth);
+    return obj;
+}
+
+
+/**
+ * @brief 紧凑格式读取可为NULL的对象
+ *
+ * @param reader 读取器
+ * @param plan 执行计划
+ * @param depth 对象的嵌套深度
+ * @return void* 对象，数据为NULL或读取失败返回NULL(通过 reader->result 区分)，
+ *         读取失败时已分配的对象也会返回，由调用者释放
+ */
+void *cCompactGetRef(CCompactReader *reader, ReflectPlan *plan, size_t depth)
+{
+    uint64_t present = cCompactGetVarint(reader);
+    if (present > 1)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return NULL;
+    }
+    return present ? cCompactNewObj(reader, plan, depth) : NULL;
+}
+
+
+/**
+ * @brief 紧凑格式读取字段
+ *        对象需要预先置0，读取失败时已读取的部分可以通过 reflectFreeObj 释放
+ *
+ * @param reader 读取器
+ * @param addr 字段地址
+ * @param field 执行计划字段
+ * @param depth 嵌套深度
+ */
+void cCompactGetField(CCompactReader *reader, void *addr, ReflectPlanField *field, size_t depth)
+{
+    if (field->isPointer)
+    {
+        *(void **)addr = cCompactGetRef(reader, field->plan, depth + 1);
+        return;
+    }
+
+    switch (field->type)
+    {
+    case REFLECT_TYPE_CHAR:
+    {
+        const unsigned char *p = cCompactGetData(reader, 1);
+        if (p)
+        {
+            *(char *)addr = (char)*p;
+        }
+        break;
+    }
+    case REFLECT_TYPE_SHORT:
+        *(short *)addr = (short)cCompactGetInt(reader, SHRT_MIN, SHRT_MAX);
+        break;
+    case REFLECT_TYPE_INT:
+        *(int *)addr = (int)cCompactGetInt(reader, INT_MIN, INT_MAX);
+        break;
+    case REFLECT_TYPE_LONG:
+        *(long *)addr = (long)cCompactGetInt(reader, LONG_MIN, LONG_MAX);
+        break;
+    case REFLECT_TYPE_FLOAT:
+    {
+        uint32_t value = (uint32_t)cCompactGetFixed(reader, sizeof(value));
+        memcpy(addr, &value, sizeof(value));
+        break;
+    }
+    case REFLECT_TYPE_DOUBLE:
+    {
+        uint64_t value = cCompactGetFixed(reader, sizeof(value));
+        memcpy(addr, &value, sizeof(value));
+        break;
+    }
+    case REFLECT_TYPE_STRING:
+    {
+        uint64_t len = cCompactGetVarint(reader);
+        if (len == 0 || reader->result != CERIAL_OK)
+        {
+            break;
+        }
+        const unsigned char *p = cCompactGetData(reader, len - 1);
+        REFLECT_ASSERT(p, break);
+        char *str = REFLECT_MALLOC(len);
+        if (!str)
+        {
+            reader->result = CERIAL_ERROR_NO_MEMORY;
+            break;
+        }
+        memcpy(str, p, len - 1);
+        str[len - 1] = 0;
+        *(char **)addr = str;
+        break;
+    }
+    case REFLECT_TYPE_STRUCT:
+        cCompactGetObj(reader, addr, field->plan, depth + 1);
+        break;
+    case REFLECT_TYPE_ARRAY:
+        for (size_t i = 0; i < field->count && reader->result == CERIAL_OK; i++)
+        {
+            cCompactGetObj(reader, (void *)((size_t)addr + field->plan->size * i),
+                           field->plan, depth + 1);
+        }
+        break;
+    case REFLECT_TYPE_LIST:
+    {
+        uint64_t count = cCompactGetVarint(reader);
+        ObjListHead items = {0};
+        /* 每个元素至少占用1字节，数量超过剩余数据时数据无效 */
+        if (count > reader->size - reader->used)
+        {
+            reader->result = CERIAL_ERROR_INVALID;
+        }
+        for (uint64_t i = 0; i < count && reader->result == CERIAL_OK; i++)
+        {
+            void *item = cCompactGetRef(reader, field->plan, depth + 1);
+            if ((item || reader->result == CERIAL_OK) && !objListHeadAdd(&items, item))
+            {
+                if (item)
+                {
+                    reflectFreePlanObj(item, field->plan, 1);
+                }
+                reader->result = CERIAL_ERROR_NO_MEMORY;
+            }
+            *(ObjList **)addr = items.head;
+        }
+        break;
+    }
+    case REFLECT_TYPE_VECTOR:
+    {
+        uint64_t count = cCompactGetVarint(reader);
+        size_t itemSize = field->plan->size;
+        size_t *countAddr = (size_t *)((size_t)addr - field->offset + field->countOffset);
+        if (count > reader->size - reader->used || reader->result != CERIAL_OK)
+        {
+            reader->result = CERIAL_ERROR_INVALID;
+            break;
+        }
+        *countAddr = count;
+        if (count == 0)
+        {
+            break;
+        }
+        char *items = REFLECT_MALLOC(itemSize * count);
+        if (!items)
+        {
+            *countAddr = 0;
+            reader->result = CERIAL_ERROR_NO_MEMORY;
+            break;
+        }
+        memset(items, 0, itemSize * count);
+        *(char **)addr = items;
+        for (size_t i = 0; i < count && reader->result == CERIAL_OK; i++)
+        {
+            cCompactGetObj(reader, items + itemSize * i, field->plan, depth + 1);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief 紧凑格式读取对象
+ *
+ * @param reader 读取器
+ * @param obj 对象，需要预先置0
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ */
+void cCompactGetObj(CCompactReader *reader, void *obj, ReflectPlan *plan, size_t depth)
+{
+    if (depth > CERIAL_COMPACT_MAX_DEPTH)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return;
+    }
+    for (size_t i = 0; i < plan->memberCount && reader->result == CERIAL_OK; i++)
+    {
+        ReflectPlanField *p = &plan->members[i];
+        cCompactGetField(reader, (void *)((size_t)obj + p->offset), p, depth);
+    }
+}
+
+
+/**
+ * @brief 紧凑格式反序列化
+ *
+ * @param mem 序列化数据地址
+ * @param size 序列化数据大小
+ * @param model Reflection 模型
+ * @param used 读取的数据大小，可为NULL
+ * @return void* 反序列化得到的对象，数据无效或内存不足返回NULL
+ */
+void *cDeserializeCompact(const void *mem, size_t size, Reflection *model, size_t *used)
+{
+    REFLECT_ASSERT(mem, return NULL);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_DESERIALIZE);
+    CCompactReader reader = {mem, size, 0, CERIAL_OK};
+    void *obj = cCompactNewObj(&reader, plan, 0);
+    if (reader.result != CERIAL_OK)
+    {
+        if (obj)
+        {
+            reflectFreePlanObj(obj, plan, 1);
+        }
+        REFLECT_STATS_END(scope, reader.used, 0);
+        return NULL;
+    }
+    if (used)
+    {
+        *used = reader.used;
+    }
+    REFLECT_STATS_END(scope, reader.used, 0);
+    return obj;
+}
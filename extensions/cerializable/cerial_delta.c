@@ -0,0 +1,657 @@
+/**
+ * @file cerial_delta.c
+ * @author agent
+ * @brief c serializable delta encoding
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "cerializable.h"
+#include "cerial_internal.h"
+#include "string.h"
+#include "stdint.h"
+#include "obj_list.h"
+
+
+#define CERIAL_DELTA_NULL           0           /**< 指针字段置为NULL */
+#define CERIAL_DELTA_REPLACE        1           /**< 指针字段替换为新对象 */
+#define CERIAL_DELTA_PATCH          2           /**< 指针字段指向的对象增量修改 */
+
+#define CERIAL_DELTA_VECTOR_PATCH   0           /**< 动态数组元素数量不变，逐个元素增量修改 */
+#define CERIAL_DELTA_VECTOR_RESIZE  1           /**< 动态数组元素数量变化，共同部分增量修改，新增元素完整写入 */
+
+
+static size_t cDeltaPutObj(CCompactWriter *writer, void *oldObj, void *newObj, ReflectPlan *plan);
+
+/**
+ * @brief 写入可为NULL的对象的增量
+ *        新对象为NULL时写入 CERIAL_DELTA_NULL，旧对象为NULL时写入 CERIAL_DELTA_REPLACE 和新对象，
+ *        否则写入 CERIAL_DELTA_PATCH 和对象增量
+ *
+ * @param writer 写入器
+ * @param oldObj 旧对象
+ * @param newObj 新对象
+ * @param plan 执行计划
+ * @return int 1 对象有变化 0 对象相同
+ */
+static int cDeltaPutRef(CCompactWriter *writer, void *oldObj, void *newObj, ReflectPlan *plan)
+{
+    if (!newObj)
+    {
+        cCompactPutVarint(writer, CERIAL_DELTA_NULL);
+        return oldObj != NULL;
+    }
+    if (!oldObj)
+    {
+        cCompactPutVarint(writer, CERIAL_DELTA_REPLACE);
+        cCompactPutObj(writer, newObj, plan);
+        return 1;
+    }
+    cCompactPutVarint(writer, CERIAL_DELTA_PATCH);
+    return cDeltaPutObj(writer, oldObj, newObj, plan) != 0;
+}
+
+/**
+ * @brief 写入链表增量
+ *        去掉两个链表相同的前缀和后缀，中间部分按位置逐个写入对象增量，
+ *        多出的新对象完整写入，多出的旧对象删除，元素可为NULL
+ *
+ * @param writer 写入器
+ * @param oldList 旧链表
+ * @param newList 新链表
+ * @param plan 链表对象执行计划
+ * @return int 1 链表有变化 0 链表相同
+ */
+static int cDeltaPutList(CCompactWriter *writer, ObjList *oldList, ObjList *newList,
+                         ReflectPlan *plan)
+{
+    size_t prefix = 0;
+    while (oldList && newList && reflectEqualsPlanObj(oldList->obj, newList->obj, plan))
+    {
+        oldList = oldList->next;
+        newList = newList->next;
+        prefix++;
+    }
+    size_t oldRest = objListGetSize(oldList);
+    size_t newRest = objListGetSize(newList);
+    if (oldRest == 0 && newRest == 0)
+    {
+        return 0;
+    }
+
+    void **items = REFLECT_MALLOC(sizeof(void *) * (oldRest + newRest));
+    if (!items)
+    {
+        writer->result = CERIAL_ERROR_NO_MEMORY;
+        return 1;
+    }
+    void **oldItems = items;
+    void **newItems = items + oldRest;
+    for (size_t i = 0; oldList; i++, oldList = oldList->next)
+    {
+        oldItems[i] = oldList->obj;
+    }
+    for (size_t i = 0; newList; i++, newList = newList->next)
+    {
+        newItems[i] = newList->obj;
+    }
+    size_t suffix = 0;
+    while (suffix < oldRest && suffix < newRest
+           && reflectEqualsPlanObj(oldItems[oldRest - 1 - suffix], newItems[newRest - 1 - suffix], plan))
+    {
+        suffix++;
+    }
+
+    size_t oldMid = oldRest - suffix;
+    size_t newMid = newRest - suffix;
+    size_t pairs = oldMid < newMid ? oldMid : newMid;
+    cCompactPutVarint(writer, prefix);
+    cCompactPutVarint(writer, oldMid);
+    cCompactPutVarint(writer, newMid);
+    for (size_t i = 0; i < pairs; i++)
+    {
+        cDeltaPutRef(writer, oldItems[i], newItems[i], plan);
+    }
+    for (size_t i = pairs; i < newMid; i++)
+    {
+        cCompactPutRef(writer, newItems[i], plan);
+    }
+    REFLECT_FREE(items);
+    return 1;
+}
+
+
+/**
+ * @brief 写入连续元素的增量
+ *        依次写入有变化的元素序号(从1开始)和元素增量，以0结束
+ *
+ * @param writer 写入器
+ * @param oldItems 旧元素
+ * @param newItems 新元素
+ * @param count 元素数量
+ * @param plan 元素执行计划
+ * @return int 1 有元素变化 0 元素相同
+ */
+static int cDeltaPutItems(CCompactWriter *writer, char *oldItems, char *newItems, size_t count,
+                          ReflectPlan *plan)
+{
+    int changed = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t mark = writer->buffer->used;
+        cCompactPutVarint(writer, i + 1);
+        if (cDeltaPutObj(writer, oldItems + plan->size * i, newItems + plan->size * i, plan))
+        {
+            changed = 1;
+        }
+        else if (writer->result == CERIAL_OK)
+        {
+            writer->buffer->used = mark;
+        }
+    }
+    cCompactPutVarint(writer, 0);
+    return changed;
+}
+
+
+/**
+ * @brief 写入动态数组增量
+ *        元素数量相同时写入元素增量，元素数量变化时写入新的数量，
+ *        共同部分的元素增量和新增的元素
+ *
+ * @param writer 写入器
+ * @param oldAddr 旧字段地址
+ * @param newAddr 新字段地址
+ * @param field 执行计划字段
+ * @return int 1 数组有变化 0 数组相同
+ */
+static int cDeltaPutVector(CCompactWriter *writer, void *oldAddr, void *newAddr, ReflectPlanField *field)
+{
+    char *oldItems = *(char **)oldAddr;
+    char *newItems = *(char **)newAddr;
+    size_t oldCount = oldItems ? *(size_t *)((size_t)oldAddr - field->offset + field->countOffset) : 0;
+    size_t newCount = newItems ? *(size_t *)((size_t)newAddr - field->offset + field->countOffset) : 0;
+    if (oldCount == newCount)
+    {
+        cCompactPutVarint(writer, CERIAL_DELTA_VECTOR_PATCH);
+        return cDeltaPutItems(writer, oldItems, newItems, newCount, field->plan);
+    }
+
+    size_t common = oldCount < newCount ? oldCount : newCount;
+    cCompactPutVarint(writer, CERIAL_DELTA_VECTOR_RESIZE);
+    cCompactPutVarint(writer, newCount);
+    cDeltaPutItems(writer, oldItems, newItems, common, field->plan);
+    for (size_t i = common; i < newCount; i++)
+    {
+        cCompactPutObj(writer, newItems + field->plan->size * i, field->plan);
+    }
+    return 1;
+}
+
+
+/**
+ * @brief 写入字段增量
+ *
+ * @param writer 写入器
+ * @param oldAddr 旧字段地址
+ * @param newAddr 新字段地址
+ * @param field 执行计划字段
+ * @return int 1 字段有变化 0 字段相同(已写入的数据由调用者丢弃)
+ */
+static int cDeltaPutField(CCompactWriter *writer, void *oldAddr, void *newAddr, ReflectPlanField *field)
+{
+    if (field->isPointer)
+    {
+        void *oldChild = *(void **)oldAddr;
+        void *newChild = *(void **)newAddr;
+        if (!oldChild && !newChild)
+        {
+            return 0;
+        }
+        return cDeltaPutRef(writer, oldChild, newChild, field->plan);
+    }
+
+    switch (field->type)
+    {
+    case REFLECT_TYPE_STRING:
+    {
+        char *oldStr = *(char **)oldAddr;
+        char *newStr = *(char **)newAddr;
+        if (oldStr == newStr || (oldStr && newStr && strcmp(oldStr, newStr) == 0))
+        {
+            return 0;
+        }
+        cCompactPutField(writer, newAddr, field);
+        return 1;
+    }
+    case REFLECT_TYPE_STRUCT:
+        return cDeltaPutObj(writer, oldAddr, newAddr, field->plan) != 0;
+    case REFLECT_TYPE_ARRAY:
+        return cDeltaPutItems(writer, oldAddr, newAddr, field->count, field->plan);
+    case REFLECT_TYPE_LIST:
+        return cDeltaPutList(writer, *(ObjList **)oldAddr, *(ObjList **)newAddr, field->plan);
+    case REFLECT_TYPE_VECTOR:
+        return cDeltaPutVector(writer, oldAddr, newAddr, field);
+    default:
+        if (memcmp(oldAddr, newAddr, field->field->size) == 0)
+        {
+            return 0;
+        }
+        cCompactPutField(writer, newAddr, field);
+        return 1;
+    }
+}
+
+
+/**
+ * @brief 写入对象增量
+ *        依次写入有变化的字段序号(从1开始)和字段增量，以0结束
+ *
+ * @param writer 写入器
+ * @param oldObj 旧对象
+ * @param newObj 新对象
+ * @param plan 执行计划
+ * @return size_t 有变化的字段数量
+ */
+static size_t cDeltaPutObj(CCompactWriter *writer, void *oldObj, void *newObj, ReflectPlan *plan)
+{
+    size_t changes = 0;
+    for (size_t i = 0; i < plan->memberCount; i++)
+    {
+        ReflectPlanField *p = &plan->members[i];
+        size_t mark = writer->buffer->used;
+        cCompactPutVarint(writer, (uint64_t)i + 1);
+        if (cDeltaPutField(writer,
+                           (void *)((size_t)oldObj + p->offset),
+                           (void *)((size_t)newObj + p->offset),
+                           p))
+        {
+            changes++;
+        }
+        else if (writer->result == CERIAL_OK)
+        {
+            writer->buffer->used = mark;
+        }
+    }
+    cCompactPutVarint(writer, 0);
+    return changes;
+}
+
+
+/**
+ * @brief 增量序列化
+ *        只写入新对象相对旧对象有变化的字段，链表写入元素的修改，插入和删除
+ *
+ * @param oldObj 旧对象
+ * @param newObj 新对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区，数据追加在 buffer->used 之后，空间不足时自动扩展
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeDelta(void *oldObj, void *newObj, Reflection *model, CSerialBuffer *buffer)
+{
+    REFLECT_ASSERT(oldObj, return CERIAL_ERROR_INVALID);
+    REFLECT_ASSERT(newObj, return CERIAL_ERROR_INVALID);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    size_t used = buffer->used;
+    CCompactWriter writer = {buffer, CERIAL_OK};
+    cDeltaPutObj(&writer, oldObj, newObj, plan);
+    if (writer.result != CERIAL_OK)
+    {
+        buffer->used = used;
+    }
+    REFLECT_STATS_END(scope, 0, buffer->used - used);
+    return writer.result;
+}
+
+
+static void cDeltaGetObj(CCompactReader *reader, void *obj, ReflectPlan *plan, size_t depth);
+
+/**
+ * @brief 读取完整的新对象
+ *
+ * @param reader 读取器
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ * @return void* 对象，失败返回NULL
+ */
+static void *cDeltaNewObj(CCompactReader *reader, ReflectPlan *plan, size_t depth)
+{
+    void *obj = REFLECT_MALLOC(plan->size);
+    if (!obj)
+    {
+        reader->result = CERIAL_ERROR_NO_MEMORY;
+        return NULL;
+    }
+    memset(obj, 0, plan->size);
+    cCompactGetObj(reader, obj, plan, depth);
+    if (reader->result != CERIAL_OK)
+    {
+        reflectFreePlanObj(obj, plan, 1);
+        return NULL;
+    }
+    return obj;
+}
+
+
+/**
+ * @brief 应用可为NULL的对象的增量
+ *
+ * @param reader 读取器
+ * @param addr 对象指针地址
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ */
+static void cDeltaGetRef(CCompactReader *reader, void **addr, ReflectPlan *plan, size_t depth)
+{
+    uint64_t op = cCompactGetVarint(reader);
+    void *child = *addr;
+    if (reader->result != CERIAL_OK)
+    {
+        return;
+    }
+    if (op == CERIAL_DELTA_PATCH && child)
+    {
+        cDeltaGetObj(reader, child, plan, depth + 1);
+    }
+    else if (op == CERIAL_DELTA_NULL || op == CERIAL_DELTA_REPLACE)
+    {
+        if (child)
+        {
+            reflectFreePlanObj(child, plan, 1);
+        }
+        *addr = op == CERIAL_DELTA_REPLACE ? cDeltaNewObj(reader, plan, depth + 1) : NULL;
+    }
+    else
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+    }
+}
+
+
+/**
+ * @brief 应用链表增量
+ *
+ * @param reader 读取器
+ * @param addr 链表字段地址
+ * @param plan 链表对象执行计划
+ * @param depth 嵌套深度
+ */
+static void cDeltaGetList(CCompactReader *reader, ObjList **addr, ReflectPlan *plan, size_t depth)
+{
+    uint64_t prefix = cCompactGetVarint(reader);
+    uint64_t oldMid = cCompactGetVarint(reader);
+    uint64_t newMid = cCompactGetVarint(reader);
+    ObjList **link = addr;
+    uint64_t i;
+    for (i = 0; i < prefix && *link; i++)
+    {
+        link = &(*link)->next;
+    }
+    if (i < prefix)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+    }
+
+    for (i = 0; i < oldMid && i < newMid && reader->result == CERIAL_OK; i++)
+    {
+        if (!*link)
+        {
+            reader->result = CERIAL_ERROR_INVALID;
+            return;
+        }
+        cDeltaGetRef(reader, &(*link)->obj, plan, depth);
+        link = &(*link)->next;
+    }
+    for (; i < oldMid && reader->result == CERIAL_OK; i++)
+    {
+        ObjList *node = *link;
+        if (!node)
+        {
+            reader->result = CERIAL_ERROR_INVALID;
+            return;
+        }
+        *link = node->next;
+        if (node->obj)
+        {
+            reflectFreePlanObj(node->obj, plan, 1);
+        }
+        objListNodeFree(node);
+    }
+    for (; i < newMid && reader->result == CERIAL_OK; i++)
+    {
+        void *item = cCompactGetRef(reader, plan, depth + 1);
+        if (reader->result != CERIAL_OK)
+        {
+            if (item)
+            {
+                reflectFreePlanObj(item, plan, 1);
+            }
+            return;
+        }
+        ObjList *node = objListNodeAlloc();
+        if (!node)
+        {
+            if (item)
+            {
+                reflectFreePlanObj(item, plan, 1);
+            }
+            reader->result = CERIAL_ERROR_NO_MEMORY;
+            return;
+        }
+        node->obj = item;
+        node->next = *link;
+        *link = node;
+        link = &node->next;
+    }
+}
+
+
+/**
+ * @brief 应用连续元素的增量
+ *
+ * @param reader 读取器
+ * @param items 元素
+ * @param count 元素数量
+ * @param plan 元素执行计划
+ * @param depth 嵌套深度
+ */
+static void cDeltaGetItems(CCompactReader *reader, char *items, size_t count, ReflectPlan *plan,
+                           size_t depth)
+{
+    uint64_t index;
+    while ((index = cCompactGetVarint(reader)) != 0 && reader->result == CERIAL_OK)
+    {
+        if (index > count)
+        {
+            reader->result = CERIAL_ERROR_INVALID;
+            break;
+        }
+        cDeltaGetObj(reader, items + plan->size * (index - 1), plan, depth + 1);
+    }
+}
+
+
+/**
+ * @brief 应用动态数组增量
+ *        元素数量变化时重新分配数组，共同部分的元素移动到新数组后应用增量，
+ *        多出的旧元素释放，新增的元素从数据中读取
+ *
+ * @param reader 读取器
+ * @param addr 字段地址
+ * @param field 执行计划字段
+ * @param depth 嵌套深度
+ */
+static void cDeltaGetVector(CCompactReader *reader, void *addr, ReflectPlanField *field, size_t depth)
+{
+    ReflectPlan *plan = field->plan;
+    uint64_t op = cCompactGetVarint(reader);
+    char *items = *(char **)addr;
+    size_t *countAddr = (size_t *)((size_t)addr - field->offset + field->countOffset);
+    size_t count = items ? *countAddr : 0;
+    if (reader->result != CERIAL_OK)
+    {
+        return;
+    }
+    if (op == CERIAL_DELTA_VECTOR_PATCH)
+    {
+        cDeltaGetItems(reader, items, count, plan, depth);
+        return;
+    }
+    if (op != CERIAL_DELTA_VECTOR_RESIZE)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return;
+    }
+
+    uint64_t newCount = cCompactGetVarint(reader);
+    /* 新增的元素每个至少占用1字节 */
+    if (reader->result != CERIAL_OK
+        || (newCount > count && newCount - count > reader->size - reader->used)
+        || newCount > SIZE_MAX / plan->size)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return;
+    }
+    size_t common = count < newCount ? count : (size_t)newCount;
+    char *newItems = NULL;
+    if (newCount > 0)
+    {
+        newItems = REFLECT_MALLOC(plan->size * newCount);
+        if (!newItems)
+        {
+            reader->result = CERIAL_ERROR_NO_MEMORY;
+            return;
+        }
+        if (common)
+        {
+            memcpy(newItems, items, plan->size * common);
+        }
+        memset(newItems + plan->size * common, 0, plan->size * (newCount - common));
+    }
+    for (size_t i = common; i < count; i++)
+    {
+        reflectFreePlanObj(items + plan->size * i, plan, 0);
+    }
+    if (items)
+    {
+        REFLECT_FREE(items);
+    }
+    *(char **)addr = newItems;
+    *countAddr = newCount;
+
+    cDeltaGetItems(reader, newItems, common, plan, depth);
+    for (size_t i = common; i < newCount && reader->result == CERIAL_OK; i++)
+    {
+        cCompactGetObj(reader, newItems + plan->size * i, plan, depth + 1);
+    }
+}
+
+
+/**
+ * @brief 应用字段增量
+ *
+ * @param reader 读取器
+ * @param addr 字段地址
+ * @param field 执行计划字段
+ * @param depth 嵌套深度
+ */
+static void cDeltaGetField(CCompactReader *reader, void *addr, ReflectPlanField *field, size_t depth)
+{
+    if (field->isPointer)
+    {
+        cDeltaGetRef(reader, (void **)addr, field->plan, depth);
+        return;
+    }
+
+    switch (field->type)
+    {
+    case REFLECT_TYPE_STRING:
+        if (*(char **)addr)
+        {
+            REFLECT_FREE(*(char **)addr);
+            *(char **)addr = NULL;
+        }
+        cCompactGetField(reader, addr, field, depth);
+        break;
+    case REFLECT_TYPE_STRUCT:
+        cDeltaGetObj(reader, addr, field->plan, depth + 1);
+        break;
+    case REFLECT_TYPE_ARRAY:
+        cDeltaGetItems(reader, addr, field->count, field->plan, depth);
+        break;
+    case REFLECT_TYPE_LIST:
+        cDeltaGetList(reader, (ObjList **)addr, field->plan, depth);
+        break;
+    case REFLECT_TYPE_VECTOR:
+        cDeltaGetVector(reader, addr, field, depth);
+        break;
+    default:
+        cCompactGetField(reader, addr, field, depth);
+        break;
+    }
+}
+
+
+/**
+ * @brief 应用对象增量
+ *
+ * @param reader 读取器
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ */
+static void cDeltaGetObj(CCompactReader *reader, void *obj, ReflectPlan *plan, size_t depth)
+{
+    if (depth > CERIAL_COMPACT_MAX_DEPTH)
+    {
+        reader->result = CERIAL_ERROR_INVALID;
+        return;
+    }
+    uint64_t index;
+    while ((index = cCompactGetVarint(reader)) != 0 && reader->result == CERIAL_OK)
+    {
+        if (index > plan->memberCount)
+        {
+            reader->result = CERIAL_ERROR_INVALID;
+            break;
+        }
+        ReflectPlanField *p = &plan->members[index - 1];
+        cDeltaGetField(reader, (void *)((size_t)obj + p->offset), p, depth);
+    }
+}
+
+
+/**
+ * @brief 应用增量
+ *        将 cSerializeDelta 得到的增量原地应用到对象上
+ *
+ * @param obj 对象，需要与生成增量时的旧对象一致
+ * @param delta 增量数据
+ * @param size 增量数据大小
+ * @param model Reflection 模型
+ * @param used 读取的数据大小，可为NULL
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_INVALID 数据无效 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cApplyDelta(void *obj, const void *delta, size_t size, Reflection *model, size_t *used)
+{
+    REFLECT_ASSERT(obj, return CERIAL_ERROR_INVALID);
+    REFLECT_ASSERT(delta, return CERIAL_ERROR_INVALID);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_DESERIALIZE);
+    CCompactReader reader = {delta, size, 0, CERIAL_OK};
+    cDeltaGetObj(&reader, obj, plan, 0);
+    if (used)
+    {
+        *used = reader.used;
+    }
+    REFLECT_STATS_END(scope, reader.used, 0);
+    return reader.result;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file cerial_internal.h
+ * @author agent
+ * @brief c serializable internal
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright (c) 2026 agent
+ * 
+ */
+
+#ifndef __CERIAL_INTERNAL_H__
+#define __CERIAL_INTERNAL_H__
+
+#include "reflection.h"
+#include "cerializable.h"
+
+/**
+ * @brief 有符号整数 zigzag 编码
+ *
+ * @param value 数值
+ */
+#define CERIAL_ZIGZAG(value) \
+        (((uint64_t)(int64_t)(value) << 1) ^ (uint64_t)((int64_t)(value) >> 63))
+
+/**
+ * @brief 有符号整数 zigzag 解码
+ *
+ * @param value 编码值
+ */
+#define CERIAL_UNZIGZAG(value) \
+        ((int64_t)((uint64_t)(value) >> 1) ^ -(int64_t)((uint64_t)(value) & 1))
+
+/**
+ * @brief 紧凑格式写入器
+ *
+ */
+typedef struct
+{
+    CSerialBuffer *buffer;                      /**< 输出缓冲区 */
+    int result;                                 /**< 写入结果 */
+} CCompactWriter;
+
+/**
+ * @brief 紧凑格式读取器
+ *
+ */
+typedef struct
+{
+    const unsigned char *data;                  /**< 数据 */
+    size_t size;                                /**< 数据大小 */
+    size_t used;                                /**< 已读取的数据大小 */
+    int result;                                 /**< 读取结果 */
+} CCompactReader;
+
+/**
+ * @brief 获取对象附加数据(对象本身之后的数据)所占用的内存大小
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ * @return size_t 占用内存大小
+ */
+size_t cSerialGetExtraSize(void *obj, ReflectPlan *plan);
+
+/**
+ * @brief 紧凑格式写入数据
+ *
+ * @param writer 写入器
+ * @param data 数据
+ * @param size 数据大小
+ */
+void cCompactPutData(CCompactWriter *writer, const void *data, size_t size);
+
+/**
+ * @brief 紧凑格式写入无符号变长整数(LEB128)
+ *
+ * @param writer 写入器
+ * @param value 数值
+ */
+void cCompactPutVarint(CCompactWriter *writer, uint64_t value);
+
+/**
+ * @brief 紧凑格式写入可为NULL的对象
+ *
+ * @param writer 写入器
+ * @param obj 对象，可为NULL
+ * @param plan 执行计划
+ */
+void cCompactPutRef(CCompactWriter *writer, void *obj, ReflectPlan *plan);
+
+/**
+ * @brief 紧凑格式写入字段
+ *
+ * @param writer 写入器
+ * @param addr 字段地址
+ * @param field 执行计划字段
+ */
+void cCompactPutField(CCompactWriter *writer, void *addr, ReflectPlanField *field);
+
+/**
+ * @brief 紧凑格式写入对象
+ *
+ * @param writer 写入器
+ * @param obj 对象
+ * @param plan 执行计划
+ */
+void cCompactPutObj(CCompactWriter *writer, void *obj, ReflectPlan *plan);
+
+/**
+ * @brief 紧凑格式读取数据
+ *
+ * @param reader 读取器
+ * @param size 数据大小
+ * @return const unsigned char* 数据地址，数据不足返回NULL
+ */
+const unsigned char *cCompactGetData(CCompactReader *reader, size_t size);
+
+/**
+ * @brief 紧凑格式读取无符号变长整数(LEB128)
+ *
+ * @param reader 读取器
+ * @return uint64_t 数值，数据无效时返回0
+ */
+uint64_t cCompactGetVarint(CCompactReader *reader);
+
+/**
+ * @brief 紧凑格式读取可为NULL的对象
+ *
+ * @param reader 读取器
+ * @param plan 执行计划
+ * @param depth 对象的嵌套深度
+ * @return void* 对象，数据为NULL或读取失败返回NULL(通过 reader->result 区分)
+ */
+void *cCompactGetRef(CCompactReader *reader, ReflectPlan *plan, size_t depth);
+
+/**
+ * @brief 紧凑格式读取字段
+ *
+ * @param reader 读取器
+ * @param addr 字段地址
+ * @param field 执行计划字段
+ * @param depth 嵌套深度
+ */
+void cCompactGetField(CCompactReader *reader, void *addr, ReflectPlanField *field, size_t depth);
+
+/**
+ * @brief 紧凑格式读取对象
+ *
+ * @param reader 读取器
+ * @param obj 对象，需要预先置0
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ */
+void cCompactGetObj(CCompactReader *reader, void *obj, ReflectPlan *plan, size_t depth);
+
+#endif /* __CERIAL_INTERNAL_H__ */
@@ -0,0 +1,266 @@
+/**
+ * @file cerial_snapshot.c
+ * @author agent
+ * @brief c serializable snapshot
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "cerializable.h"
+#include "string.h"
+#include "obj_list.h"
+
+#if CERIAL_SNAPSHOT_ENABLE == 1
+#include "stdio.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#endif
+
+
+/**
+ * @brief 解析相对偏移
+ *
+ * @param field 字段地址
+ * @return void* 指向的地址，偏移为0时返回NULL
+ */
+static void *cViewResolve(void *field)
+{
+    size_t offset = *(size_t *)field;
+    return offset ? (void *)((size_t)field + offset) : NULL;
+}
+
+
+/**
+ * @brief 获取序列化对象视图的字段
+ *        直接在序列化数据(未反序列化)上访问字段，不分配内存
+ *
+ * @param view 序列化对象视图
+ * @param field 字段模型(模型数组中的元素)
+ * @return void* 字段数据地址，指针，字符串字段返回指向的数据(子对象视图，字符串)，
+ *               数组返回首元素，动态数组返回首元素(元素连续存储)，链表字段返回NULL(使用 cViewListItem 访问)
+ */
+void *cViewField(void *view, Reflection *field)
+{
+    REFLECT_ASSERT(view, return NULL);
+    void *addr = (void *)((size_t)view + field->offset);
+    if (field->isPointer || field->type == REFLECT_TYPE_STRING
+        || field->type == REFLECT_TYPE_VECTOR)
+    {
+        return cViewResolve(addr);
+    }
+    else if (field->type == REFLECT_TYPE_LIST)
+    {
+        return NULL;
+    }
+    return addr;
+}
+
+
+/**
+ * @brief 获取序列化对象视图的数组元素
+ *
+ * @param view 序列化对象视图
+ * @param field 数组字段模型
+ * @param index 元素序号
+ * @return void* 元素视图，序号越界返回NULL
+ */
+void *cViewArrayItem(void *view, Reflection *field, size_t index)
+{
+    REFLECT_ASSERT(view, return NULL);
+    if (field->type != REFLECT_TYPE_ARRAY || index >= field->size)
+    {
+        return NULL;
+    }
+    ReflectPlan *plan = reflectCompileModel(field->model);
+    REFLECT_ASSERT(plan, return NULL);
+    return (void *)((size_t)view + field->offset + plan->size * index);
+}
+
+
+/**
+ * @brief 获取序列化对象视图的链表大小
+ *
+ * @param view 序列化对象视图
+ * @param field 链表字段模型
+ * @return size_t 链表大小
+ */
+size_t cViewListSize(void *view, Reflection *field)
+{
+    REFLECT_ASSERT(view, return 0);
+    ObjList *list = cViewResolve((void *)((size_t)view + field->offset));
+    size_t size = 0;
+    if (list)
+    {
+        do {
+            size++;
+        } while ((list++)->next);
+    }
+    return size;
+}
+
+
+/**
+ * @brief 获取序列化对象视图的链表对象
+ *        序列化数据中链表节点连续存储，按序号访问为O(1)
+ *
+ * @param view 序列化对象视图
+ * @param field 链表字段模型
+ * @param index 对象序号，需要小于 cViewListSize 得到的链表大小
+ * @return void* 对象视图
+ */
+void *cViewListItem(void *view, Reflection *field, size_t index)
+{
+    REFLECT_ASSERT(view, return NULL);
+    ObjList *list = cViewResolve((void *)((size_t)view + field->offset));
+    REFLECT_ASSERT(list, return NULL);
+    return cViewResolve(&list[index].obj);
+}
+
+
+#if CERIAL_SNAPSHOT_ENABLE == 1
+
+/**
+ * @brief 快照文件写函数
+ *
+ * @param context 文件
+ * @param data 数据
+ * @param size 数据大小
+ * @return int 0 成功 -1 失败
+ */
+static int cSnapshotWrite(void *context, const void *data, size_t size)
+{
+    return fwrite(data, 1, size, (FILE *)context) == size ? 0 : -1;
+}
+
+
+/**
+ * @brief 获取快照文件头
+ *
+ * @param header 文件头
+ * @param model Reflection 模型
+ * @param size 序列化数据大小
+ */
+static void cSnapshotGetHeader(CSnapshotHeader *header, Reflection *model, size_t size)
+{
+    uint16_t endian = 1;
+    memset(header, 0, sizeof(CSnapshotHeader));
+    memcpy(header->magic, CERIAL_SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->version = CERIAL_SNAPSHOT_VERSION;
+    header->pointerSize = sizeof(size_t);
+    header->littleEndian = *(uint8_t *)&endian;
+    header->fingerprint = reflectGetModelFingerprint(model);
+    header->size = size;
+    header->alignment = sizeof(size_t);
+}
+
+
+/**
+ * @brief 保存快照文件
+ *
+ * @param path 文件路径
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return int CERIAL_OK 成功 其他 错误
+ */
+int cSnapshotSave(const char *path, void *obj, Reflection *model)
+{
+    CSnapshotHeader header;
+    size_t size = 0;
+    FILE *file = fopen(path, "wb");
+    REFLECT_ASSERT(file, return CERIAL_ERROR_IO);
+
+    /* 先写入空的文件头，数据写入完成后再写入实际的文件头 */
+    memset(&header, 0, sizeof(CSnapshotHeader));
+    int result = fwrite(&header, 1, sizeof(CSnapshotHeader), file) == sizeof(CSnapshotHeader)
+        ? cSerializeStream(obj, model, cSnapshotWrite, file, 0, &size)
+        : CERIAL_ERROR_IO;
+    if (result == CERIAL_OK)
+    {
+        cSnapshotGetHeader(&header, model, size);
+        if (fseek(file, 0, SEEK_SET) != 0
+            || fwrite(&header, 1, sizeof(CSnapshotHeader), file) != sizeof(CSnapshotHeader))
+        {
+            result = CERIAL_ERROR_IO;
+        }
+    }
+    if (fclose(file) != 0 && result == CERIAL_OK)
+    {
+        result = CERIAL_ERROR_IO;
+    }
+    return result;
+}
+
+
+/**
+ * @brief 打开快照文件
+ *        文件以只读方式映射到内存，通过 snapshot->root 和 cView 系列接口直接访问，不进行反序列化
+ *
+ * @param snapshot 快照
+ * @param path 文件路径
+ * @param model Reflection 模型
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_INVALID 文件格式或模型不匹配 CERIAL_ERROR_IO 文件读取失败
+ */
+int cSnapshotOpen(CSnapshot *snapshot, const char *path, Reflection *model)
+{
+    struct stat st;
+    CSnapshotHeader expect;
+    memset(snapshot, 0, sizeof(CSnapshot));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return CERIAL_ERROR_IO;
+    }
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return CERIAL_ERROR_IO;
+    }
+    if ((size_t)st.st_size < sizeof(CSnapshotHeader))
+    {
+        close(fd);
+        return CERIAL_ERROR_INVALID;
+    }
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return CERIAL_ERROR_IO;
+    }
+
+    CSnapshotHeader *header = map;
+    cSnapshotGetHeader(&expect, model, header->size);
+    if (memcmp(header, &expect, sizeof(CSnapshotHeader)) != 0
+        || header->size > (uint64_t)st.st_size - sizeof(CSnapshotHeader))
+    {
+        munmap(map, st.st_size);
+        return CERIAL_ERROR_INVALID;
+    }
+
+    snapshot->map = map;
+    snapshot->mapSize = st.st_size;
+    snapshot->root = (char *)map + sizeof(CSnapshotHeader);
+    snapshot->size = header->size;
+    return CERIAL_OK;
+}
+
+
+/**
+ * @brief 关闭快照文件
+ *
+ * @param snapshot 快照
+ */
+void cSnapshotClose(CSnapshot *snapshot)
+{
+    if (snapshot->map)
+    {
+        munmap(snapshot->map, snapshot->mapSize);
+    }
+    memset(snapshot, 0, sizeof(CSnapshot));
+}
+
+#endif
@@ -0,0 +1,1289 @@
+/**
+ * @file cerial_stream.c
+ * @author agent
+ * @brief c serializable stream
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "cerializable.h"
+#include "cerial_internal.h"
+#include "string.h"
+#include "obj_list.h"
+#include "obj_map.h"
+
+#if CERIAL_STREAM_SIZE_CACHE < 1
+#error "CERIAL_STREAM_SIZE_CACHE must be at least 1"
+#endif
+
+
+/**
+ * @brief 子数据序列化大小记录
+ *
+ */
+typedef struct
+{
+    void *key;                                  /**< 对象/链表/元素地址，为NULL时记录已删除 */
+    ReflectPlan *plan;                          /**< 执行计划 */
+    size_t count;                               /**< 动态数组元素数量，其他数据为0 */
+    size_t size;                                /**< 序列化大小 */
+} CStreamSize;
+
+/**
+ * @brief 流式序列化输出
+ *        序列化数据按顺序输出，对象的指针字段在输出前根据子对象大小计算相对偏移，
+ *        子对象大小在首次使用时按后序计算并记录，各层对象计算偏移时直接使用记录的大小，
+ *        父对象的偏移写入后记录即被删除，记录不超过 CERIAL_STREAM_SIZE_CACHE 条，
+ *        记录已满时替换最早的记录，被替换的大小之后使用时重新计算
+ *
+ */
+typedef struct
+{
+    CSerialWrite write;                         /**< 写函数 */
+    void *context;                              /**< 写函数用户上下文 */
+    char *window;                               /**< 窗口缓冲区 */
+    size_t windowSize;                          /**< 窗口大小 */
+    size_t windowUsed;                          /**< 窗口已使用大小 */
+    size_t offset;                              /**< 已输出的数据大小 */
+    char *stage;                                /**< 对象暂存区 */
+    size_t stageSize;                           /**< 对象暂存区大小 */
+    int result;                                 /**< 输出结果 */
+    ObjMap objSizes;                            /**< 子对象大小，对象地址 -> 记录序号 */
+    ObjMap blockSizes;                          /**< 链表和动态数组大小，链表/元素地址 -> 记录序号 */
+    CStreamSize *sizes;                         /**< 大小记录 */
+    size_t sizeCount;                           /**< 大小记录数量 */
+    size_t sizeCapacity;                        /**< 大小记录容量 */
+    size_t sizeNext;                            /**< 记录已满时下一个被替换的记录序号 */
+} CSerialStream;
+
+
+/**
+ * @brief 输出窗口中的数据
+ *
+ * @param stream 流
+ */
+static void cStreamFlush(CSerialStream *stream)
+{
+    if (stream->result == CERIAL_OK && stream->windowUsed
+        && stream->write(stream->context, stream->window, stream->windowUsed) != 0)
+    {
+        stream->result = CERIAL_ERROR_IO;
+    }
+    stream->windowUsed = 0;
+}
+
+
+/**
+ * @brief 输出数据
+ *
+ * @param stream 流
+ * @param data 数据，为NULL时输出0
+ * @param size 数据大小
+ */
+static void cStreamPut(CSerialStream *stream, const void *data, size_t size)
+{
+    stream->offset += size;
+    while (size && stream->result == CERIAL_OK)
+    {
+        size_t len = stream->windowSize - stream->windowUsed;
+        if (len > size)
+        {
+            len = size;
+        }
+        if (data)
+        {
+            memcpy(stream->window + stream->windowUsed, data, len);
+            data = (const char *)data + len;
+        }
+        else
+        {
+            memset(stream->window + stream->windowUsed, 0, len);
+        }
+        stream->windowUsed += len;
+        size -= len;
+        if (stream->windowUsed == stream->windowSize)
+        {
+            cStreamFlush(stream);
+        }
+    }
+}
+
+
+/**
+ * @brief 查找记录的大小
+ *
+ * @param stream 流
+ * @param map 大小映射表
+ * @param key 对象/链表/元素地址
+ * @param plan 执行计划
+ * @param count 动态数组元素数量，其他数据为0
+ * @return CStreamSize* 记录，未记录或执行计划不同返回NULL
+ */
+static CStreamSize *cStreamFindSize(CSerialStream *stream, ObjMap *map, void *key,
+                                    ReflectPlan *plan, size_t count)
+{
+    size_t index = (size_t)objMapGet(map, key);
+    if (index && stream->sizes[index - 1].plan == plan && stream->sizes[index - 1].count == count)
+    {
+        return &stream->sizes[index - 1];
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief 删除大小记录
+ *
+ * @param stream 流
+ * @param record 记录
+ */
+static void cStreamDropSize(CSerialStream *stream, CStreamSize *record)
+{
+    void *index = (void *)(record - stream->sizes + 1);
+    ObjMapEntry *entry = objMapFind(&stream->objSizes, record->key);
+    if (entry && entry->value == index)
+    {
+        objMapRemove(&stream->objSizes, record->key);
+    }
+    else
+    {
+        objMapRemove(&stream->blockSizes, record->key);
+    }
+    record->key = NULL;
+}
+
+
+/**
+ * @brief 记录大小
+ *        记录已满时替换最早的记录，按后序计算时较早记录的是较深层的子数据，使用得也最晚，
+ *        内存不足时不记录，之后使用时重新计算
+ *
+ * @param stream 流
+ * @param map 大小映射表
+ * @param key 对象/链表/元素地址
+ * @param plan 执行计划
+ * @param count 动态数组元素数量，其他数据为0
+ * @param size 序列化大小
+ * @return size_t 序列化大小
+ */
+static size_t cStreamSaveSize(CSerialStream *stream, ObjMap *map, void *key,
+                              ReflectPlan *plan, size_t count, size_t size)
+{
+    if (objMapFind(map, key))
+    {
+        return size;
+    }
+    size_t index = stream->sizeCount;
+    if (index < CERIAL_STREAM_SIZE_CACHE)
+    {
+        if (index == stream->sizeCapacity)
+        {
+            size_t capacity = stream->sizeCapacity ? stream->sizeCapacity * 2 : 64;
+            capacity = capacity > CERIAL_STREAM_SIZE_CACHE ? CERIAL_STREAM_SIZE_CACHE : capacity;
+            CStreamSize *sizes = REFLECT_MALLOC(sizeof(CStreamSize) * capacity);
+            REFLECT_ASSERT(sizes, return size);
+            if (stream->sizes)
+            {
+                memcpy(sizes, stream->sizes, sizeof(CStreamSize) * stream->sizeCount);
+                REFLECT_FREE(stream->sizes);
+            }
+            stream->sizes = sizes;
+            stream->sizeCapacity = capacity;
+        }
+        stream->sizeCount++;
+    }
+    else
+    {
+        index = stream->sizeNext;
+        stream->sizeNext = (index + 1) % CERIAL_STREAM_SIZE_CACHE;
+        if (stream->sizes[index].key)
+        {
+            cStreamDropSize(stream, &stream->sizes[index]);
+        }
+    }
+    CStreamSize *record = &stream->sizes[index];
+    record->key = NULL;
+    if (objMapPut(map, key, (void *)(index + 1)) == 0)
+    {
+        record->key = key;
+        record->plan = plan;
+        record->count = count;
+        record->size = size;
+    }
+    return size;
+}
+
+
+/**
+ * @brief 取出记录的大小，记录随即被删除
+ *
+ * @param stream 流
+ * @param record 记录
+ * @return size_t 序列化大小
+ */
+static size_t cStreamTakeSize(CSerialStream *stream, CStreamSize *record)
+{
+    size_t size = record->size;
+    cStreamDropSize(stream, record);
+    return size;
+}
+
+
+static size_t cStreamMeasure(CSerialStream *stream, void *obj, ReflectPlan *plan);
+
+/**
+ * @brief 获取子对象的序列化大小
+ *
+ * @param stream 流
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param take 是否为最后一次使用，为1时删除记录，不再记录
+ * @return size_t 对象及其附加数据的大小
+ */
+static size_t cStreamObjSize(CSerialStream *stream, void *obj, ReflectPlan *plan, int take)
+{
+    CStreamSize *record = cStreamFindSize(stream, &stream->objSizes, obj, plan, 0);
+    if (record)
+    {
+        return take ? cStreamTakeSize(stream, record) : record->size;
+    }
+    size_t size = plan->alignedSize + cStreamMeasure(stream, obj, plan);
+    /* 没有附加数据的对象重新计算时不会递归，不需要记录 */
+    return size > plan->alignedSize && !take
+        ? cStreamSaveSize(stream, &stream->objSizes, obj, plan, 0, size) : size;
+}
+
+
+/**
+ * @brief 获取链表的序列化大小
+ *
+ * @param stream 流
+ * @param list 链表
+ * @param plan 链表对象执行计划
+ * @param take 是否为最后一次使用，为1时删除记录，不再记录，链表对象的记录保留到输出链表节点时
+ * @return size_t 链表节点和所有对象的大小
+ */
+static size_t cStreamListSize(CSerialStream *stream, ObjList *list, ReflectPlan *plan, int take)
+{
+    CStreamSize *record = cStreamFindSize(stream, &stream->blockSizes, list, plan, 0);
+    if (record)
+    {
+        return take ? cStreamTakeSize(stream, record) : record->size;
+    }
+    size_t size = 0;
+    for (ObjList *item = list; item; item = item->next)
+    {
+        size += sizeof(ObjList) + cStreamObjSize(stream, item->obj, plan, 0);
+    }
+    return take ? size : cStreamSaveSize(stream, &stream->blockSizes, list, plan, 0, size);
+}
+
+
+/**
+ * @brief 获取动态数组的序列化大小
+ *
+ * @param stream 流
+ * @param items 元素
+ * @param count 元素数量
+ * @param plan 元素执行计划
+ * @param take 是否为最后一次使用，为1时删除记录，不再记录
+ * @return size_t 元素和各元素附加数据的大小
+ */
+static size_t cStreamVectorSize(CSerialStream *stream, char *items, size_t count,
+                                ReflectPlan *plan, int take)
+{
+    size_t size = REFLECT_ALIGN(plan->size * count);
+    if (plan->isPlain)
+    {
+        return size;
+    }
+    CStreamSize *record = cStreamFindSize(stream, &stream->blockSizes, items, plan, count);
+    if (record)
+    {
+        return take ? cStreamTakeSize(stream, record) : record->size;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        size += cStreamMeasure(stream, items + plan->size * i, plan);
+    }
+    return take ? size : cStreamSaveSize(stream, &stream->blockSizes, items, plan, count, size);
+}
+
+
+/**
+ * @brief 计算对象附加数据的大小
+ *        子对象，链表和动态数组的大小在计算的同时记录
+ *
+ * @param stream 流
+ * @param obj 对象
+ * @param plan 执行计划
+ * @return size_t 附加数据大小
+ */
+static size_t cStreamMeasure(CSerialStream *stream, void *obj, ReflectPlan *plan)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        if (p->isPointer)
+        {
+            if (*(void **)addr)
+            {
+                size += cStreamObjSize(stream, *(void **)addr, p->plan, 0);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            if (*(char **)addr)
+            {
+                size += REFLECT_ALIGN(strlen(*(char **)addr) + 1);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                size += cStreamMeasure(stream, (void *)((size_t)addr + p->plan->size * j), p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            size += cStreamMeasure(stream, addr, p->plan);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            if (*(ObjList **)addr)
+            {
+                size += cStreamListSize(stream, *(ObjList **)addr, p->plan, 0);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            if (items && count)
+            {
+                size += cStreamVectorSize(stream, items, count, p->plan, 0);
+            }
+        }
+    }
+    return size;
+}
+
+
+/**
+ * @brief 计算暂存对象的字段相对偏移
+ *        字段指向的数据大小在此最后一次使用(链表对象除外)，使用后删除记录
+ *
+ * @param stream 流
+ * @param obj 对象
+ * @param stage 暂存的对象数据
+ * @param fieldBase 对象在流中的位置
+ * @param plan 执行计划
+ * @param cursor 对象附加数据在流中的位置
+ * @return size_t 对象附加数据结束后在流中的位置
+ */
+static size_t cStreamPatch(CSerialStream *stream, void *obj, char *stage, size_t fieldBase,
+                           ReflectPlan *plan, size_t cursor)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        size_t *field = (size_t *)(stage + p->offset);
+        size_t fieldOffset = fieldBase + p->offset;
+        if (p->isPointer)
+        {
+            if (*(void **)addr)
+            {
+                *field = cursor - fieldOffset;
+                cursor += cStreamObjSize(stream, *(void **)addr, p->plan, 1);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            if (*(char **)addr)
+            {
+                *field = cursor - fieldOffset;
+                cursor += REFLECT_ALIGN(strlen(*(char **)addr) + 1);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                cursor = cStreamPatch(stream, (void *)((size_t)addr + p->plan->size * j),
+                    (char *)field + p->plan->size * j,
+                    fieldOffset + p->plan->size * j,
+                    p->plan, cursor);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            cursor = cStreamPatch(stream, addr, (char *)field, fieldOffset, p->plan, cursor);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            ObjList *list = *(ObjList **)addr;
+            if (list)
+            {
+                *field = cursor - fieldOffset;
+                cursor += cStreamListSize(stream, list, p->plan, 1);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            *field = 0;
+            if (items && count)
+            {
+                *field = cursor - fieldOffset;
+                cursor += cStreamVectorSize(stream, items, count, p->plan, 1);
+            }
+        }
+    }
+    return cursor;
+}
+
+
+static void cStreamPutObj(CSerialStream *stream, void *obj, ReflectPlan *plan);
+static void cStreamPutFields(CSerialStream *stream, void *obj, ReflectPlan *plan);
+
+/**
+ * @brief 准备对象暂存区
+ *
+ * @param stream 流
+ * @param size 需要的暂存区大小
+ * @return int 0 成功 -1 内存不足
+ */
+static int cStreamStage(CSerialStream *stream, size_t size)
+{
+    if (size > stream->stageSize)
+    {
+        if (stream->stage)
+        {
+            REFLECT_FREE(stream->stage);
+        }
+        stream->stage = REFLECT_MALLOC(size);
+        stream->stageSize = stream->stage ? size : 0;
+        if (!stream->stage)
+        {
+            stream->result = CERIAL_ERROR_NO_MEMORY;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 输出动态数组
+ *        元素连续输出，含指针字段的元素经暂存区修正相对偏移后输出，之后依次输出各元素字段指向的数据
+ *
+ * @param stream 流
+ * @param items 元素
+ * @param count 元素数量
+ * @param plan 元素执行计划
+ */
+static void cStreamPutVector(CSerialStream *stream, char *items, size_t count, ReflectPlan *plan)
+{
+    size_t size = plan->size * count;
+    if (plan->isPlain)
+    {
+        cStreamPut(stream, items, size);
+        cStreamPut(stream, NULL, REFLECT_ALIGN(size) - size);
+        return;
+    }
+    if (cStreamStage(stream, plan->size) != 0)
+    {
+        return;
+    }
+    size_t itemsOffset = stream->offset;
+    size_t cursor = itemsOffset + REFLECT_ALIGN(size);
+    for (size_t i = 0; i < count; i++)
+    {
+        memcpy(stream->stage, items + plan->size * i, plan->size);
+        cursor = cStreamPatch(stream, items + plan->size * i, stream->stage,
+            itemsOffset + plan->size * i, plan, cursor);
+        cStreamPut(stream, stream->stage, plan->size);
+    }
+    cStreamPut(stream, NULL, REFLECT_ALIGN(size) - size);
+    for (size_t i = 0; i < count && stream->result == CERIAL_OK; i++)
+    {
+        cStreamPutFields(stream, items + plan->size * i, plan);
+    }
+}
+
+
+/**
+ * @brief 输出对象字段指向的数据
+ *
+ * @param stream 流
+ * @param obj 对象
+ * @param plan 执行计划
+ */
+static void cStreamPutFields(CSerialStream *stream, void *obj, ReflectPlan *plan)
+{
+    for (size_t i = 0; i < plan->fieldCount && stream->result == CERIAL_OK; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        if (p->isPointer)
+        {
+            if (*(void **)addr)
+            {
+                cStreamPutObj(stream, *(void **)addr, p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            if (*(char **)addr)
+            {
+                size_t len = strlen(*(char **)addr) + 1;
+                cStreamPut(stream, *(char **)addr, len);
+                cStreamPut(stream, NULL, REFLECT_ALIGN(len) - len);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                cStreamPutFields(stream, (void *)((size_t)addr + p->plan->size * j), p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            cStreamPutFields(stream, addr, p->plan);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            ObjList *list = *(ObjList **)addr;
+            if (list)
+            {
+                size_t nodeOffset = stream->offset;
+                size_t itemOffset = nodeOffset + sizeof(ObjList) * objListGetSize(list);
+                for (ObjList *item = list; item; item = item->next)
+                {
+                    ObjList node;
+                    node.obj = (void *)(itemOffset - (nodeOffset + offsetof(ObjList, obj)));
+                    node.next = item->next ? (ObjList *)sizeof(ObjList) : 0;
+                    cStreamPut(stream, &node, sizeof(ObjList));
+                    nodeOffset += sizeof(ObjList);
+                    itemOffset += cStreamObjSize(stream, item->obj, p->plan, 1);
+                }
+                for (; list; list = list->next)
+                {
+                    cStreamPutObj(stream, list->obj, p->plan);
+                }
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            if (items && count)
+            {
+                cStreamPutVector(stream, items, count, p->plan);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief 输出对象
+ *
+ * @param stream 流
+ * @param obj 对象
+ * @param plan 执行计划
+ */
+static void cStreamPutObj(CSerialStream *stream, void *obj, ReflectPlan *plan)
+{
+    if (stream->result != CERIAL_OK || cStreamStage(stream, plan->alignedSize) != 0)
+    {
+        return;
+    }
+    memcpy(stream->stage, obj, plan->size);
+    memset(stream->stage + plan->size, 0, plan->alignedSize - plan->size);
+    cStreamPatch(stream, obj, stream->stage, stream->offset, plan, stream->offset + plan->alignedSize);
+    cStreamPut(stream, stream->stage, plan->alignedSize);
+    cStreamPutFields(stream, obj, plan);
+}
+
+
+/**
+ * @brief 流式序列化
+ *        序列化数据经过固定大小的窗口缓冲，分段通过写函数输出，不需要完整的序列化数据内存，
+ *        除窗口外只占用最大对象的暂存区和最多 CERIAL_STREAM_SIZE_CACHE 条子数据大小记录
+ *
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param write 写函数
+ * @param context 写函数用户上下文
+ * @param window 窗口大小，为0时使用 CERIAL_STREAM_WINDOW
+ * @param size 序列化后的数据大小，可为NULL
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_IO 写函数失败 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeStream(void *obj, Reflection *model, CSerialWrite write, void *context,
+                     size_t window, size_t *size)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+
+    CSerialStream stream = {0};
+    stream.write = write;
+    stream.context = context;
+    stream.windowSize = window ? window : CERIAL_STREAM_WINDOW;
+    stream.window = REFLECT_MALLOC(stream.windowSize);
+    REFLECT_ASSERT(stream.window, return CERIAL_ERROR_NO_MEMORY);
+
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    cStreamPutObj(&stream, obj, plan);
+    cStreamFlush(&stream);
+    REFLECT_STATS_END(scope, 0, stream.offset);
+
+    REFLECT_FREE(stream.window);
+    if (stream.stage)
+    {
+        REFLECT_FREE(stream.stage);
+    }
+    if (stream.sizes)
+    {
+        REFLECT_FREE(stream.sizes);
+    }
+    objMapClear(&stream.objSizes);
+    objMapClear(&stream.blockSizes);
+    if (size)
+    {
+        *size = stream.offset;
+    }
+    return stream.result;
+}
+
+
+#define CERIAL_STREAM_TASK_OBJ      0           /**< 读取对象 */
+#define CERIAL_STREAM_TASK_FIELDS   1           /**< 处理对象字段 */
+#define CERIAL_STREAM_TASK_ARRAY    2           /**< 处理数组元素 */
+#define CERIAL_STREAM_TASK_STRING   3           /**< 读取字符串 */
+#define CERIAL_STREAM_TASK_NODES    4           /**< 读取链表节点 */
+#define CERIAL_STREAM_TASK_ITEMS    5           /**< 处理链表对象 */
+#define CERIAL_STREAM_TASK_VECTOR   6           /**< 读取动态数组元素 */
+
+#define CERIAL_STREAM_READ_SIZE     512         /**< 读函数每次读取的最大数据大小 */
+
+/**
+ * @brief 流式反序列化任务
+ * 
+ */
+typedef struct cerial_stream_task
+{
+    char type;                                  /**< 任务类型 */
+    ReflectPlan *plan;                          /**< 执行计划 */
+    void *obj;                                  /**< 对象 */
+    void **dest;                                /**< 完成后写入的字段 */
+    size_t index;                               /**< 已读取的大小/字段序号/元素序号 */
+    size_t count;                               /**< 元素数量/节点数量/剩余对象数量/动态数组元素数量 */
+    ObjListHead list;                           /**< 已构建的链表 */
+    ObjList node;                               /**< 正在读取的链表节点 */
+} CDeserialTask;
+
+/**
+ * @brief 待读取字段标记
+ *        对象读取完成后，非空的指针字段先置为其数据的绝对偏移(最低位置1)，
+ *        读取到对应数据后再替换，有效的指针最低位总是0
+ * 
+ */
+#define CERIAL_STREAM_MARK(offset)  ((void *)(((size_t)(offset) << 1) | 1))
+#define CERIAL_STREAM_MARKED(field) ((size_t)(field) & 1)
+#define CERIAL_STREAM_TARGET(field) ((size_t)(field) >> 1)
+
+
+/**
+ * @brief 流式反序列化添加任务
+ * 
+ * @param stream 反序列化器
+ * @param type 任务类型
+ * @param plan 执行计划
+ * @param obj 对象
+ * @param dest 完成后写入的字段
+ * @return CDeserialTask* 任务，内存不足返回NULL
+ */
+static CDeserialTask *cStreamPush(CDeserialStream *stream, char type,
+                                  ReflectPlan *plan, void *obj, void **dest)
+{
+    if (stream->taskCount == stream->taskSize)
+    {
+        size_t size = stream->taskSize ? stream->taskSize * 2 : 16;
+        CDeserialTask *tasks = REFLECT_MALLOC(sizeof(CDeserialTask) * size);
+        if (!tasks)
+        {
+            stream->result = CERIAL_ERROR_NO_MEMORY;
+            return NULL;
+        }
+        if (stream->tasks)
+        {
+            memcpy(tasks, stream->tasks, sizeof(CDeserialTask) * stream->taskCount);
+            REFLECT_FREE(stream->tasks);
+        }
+        stream->tasks = tasks;
+        stream->taskSize = size;
+    }
+    CDeserialTask *task = &stream->tasks[stream->taskCount++];
+    memset(task, 0, sizeof(CDeserialTask));
+    task->type = type;
+    task->plan = plan;
+    task->obj = obj;
+    task->dest = dest;
+    return task;
+}
+
+
+/**
+ * @brief 标记对象中待读取的字段
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param offset 对象在数据中的偏移
+ */
+static void cStreamMark(void *obj, ReflectPlan *plan, size_t offset)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void **field = (void **)((size_t)obj + p->offset);
+        if (p->type == REFLECT_TYPE_ARRAY && !p->isPointer)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                cStreamMark((void *)((size_t)field + p->plan->size * j), p->plan,
+                    offset + p->offset + p->plan->size * j);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT && !p->isPointer)
+        {
+            cStreamMark(field, p->plan, offset + p->offset);
+        }
+        else
+        {
+            *field = *field ? CERIAL_STREAM_MARK(offset + p->offset + (size_t)*field) : NULL;
+        }
+    }
+}
+
+
+/**
+ * @brief 清除对象中未读取的字段标记
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ */
+static void cStreamUnmark(void *obj, ReflectPlan *plan)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void **field = (void **)((size_t)obj + p->offset);
+        if (!p->isPointer && p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                cStreamUnmark((void *)((size_t)field + p->plan->size * j), p->plan);
+            }
+        }
+        else if (!p->isPointer && p->type == REFLECT_TYPE_STRUCT)
+        {
+            cStreamUnmark(field, p->plan);
+        }
+        else if (CERIAL_STREAM_MARKED(*field))
+        {
+            *field = NULL;
+        }
+        else if (p->isPointer && *field)
+        {
+            cStreamUnmark(*field, p->plan);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            for (ObjList *list = *field; list; list = list->next)
+            {
+                if (list->obj)
+                {
+                    cStreamUnmark(list->obj, p->plan);
+                }
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR && *field)
+        {
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            for (size_t j = 0; j < count; j++)
+            {
+                cStreamUnmark((char *)*field + p->plan->size * j, p->plan);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief 处理对象字段任务，为下一个待读取的字段添加任务
+ * 
+ * @param stream 反序列化器
+ * @param task 任务
+ */
+static void cStreamFields(CDeserialStream *stream, CDeserialTask *task)
+{
+    ReflectPlan *plan = task->plan;
+    while (task->index < plan->fieldCount)
+    {
+        ReflectPlanField *p = &plan->fields[task->index++];
+        void **field = (void **)((size_t)task->obj + p->offset);
+        if (!p->isPointer && p->type == REFLECT_TYPE_ARRAY)
+        {
+            task = cStreamPush(stream, CERIAL_STREAM_TASK_ARRAY, p->plan, field, NULL);
+            if (task)
+            {
+                task->count = p->count;
+            }
+            return;
+        }
+        else if (!p->isPointer && p->type == REFLECT_TYPE_STRUCT)
+        {
+            cStreamPush(stream, CERIAL_STREAM_TASK_FIELDS, p->plan, field, NULL);
+            return;
+        }
+        else if (!CERIAL_STREAM_MARKED(*field))
+        {
+            continue;
+        }
+        size_t target = CERIAL_STREAM_TARGET(*field);
+        *field = NULL;
+        if (target != stream->offset)
+        {
+            /* 数据不在当前位置时只能是字符串表中已经读取的字符串 */
+            char *str = p->type == REFLECT_TYPE_STRING && target < stream->offset
+                ? objMapGet(&stream->strings, (void *)target) : NULL;
+            if (!str)
+            {
+                stream->result = CERIAL_ERROR_INVALID;
+                return;
+            }
+            *field = reflectNewString(str);
+            if (!*field)
+            {
+                stream->result = CERIAL_ERROR_NO_MEMORY;
+                return;
+            }
+            continue;
+        }
+        if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            size_t count = *(size_t *)((size_t)task->obj + p->countOffset);
+            if (count == 0 || count > (size_t)-1 / p->plan->size)
+            {
+                stream->result = CERIAL_ERROR_INVALID;
+                return;
+            }
+            task = cStreamPush(stream, CERIAL_STREAM_TASK_VECTOR, p->plan, NULL, field);
+            if (task)
+            {
+                task->count = count;
+            }
+            return;
+        }
+        task = cStreamPush(stream,
+            p->isPointer ? CERIAL_STREAM_TASK_OBJ
+                : p->type == REFLECT_TYPE_STRING ? CERIAL_STREAM_TASK_STRING
+                : CERIAL_STREAM_TASK_NODES,
+            p->plan, NULL, field);
+        if (task && task->type == CERIAL_STREAM_TASK_STRING)
+        {
+            /* 读取字符串期间 index 记录字符串偏移 */
+            task->index = target;
+        }
+        return;
+    }
+    stream->taskCount--;
+}
+
+
+/**
+ * @brief 处理不需要读取数据的任务，直到栈顶任务需要读取数据
+ * 
+ * @param stream 反序列化器
+ */
+static void cStreamSettle(CDeserialStream *stream)
+{
+    while (stream->taskCount && stream->result == CERIAL_PENDING)
+    {
+        CDeserialTask *task = &stream->tasks[stream->taskCount - 1];
+        if (task->type == CERIAL_STREAM_TASK_FIELDS)
+        {
+            cStreamFields(stream, task);
+        }
+        else if (task->type == CERIAL_STREAM_TASK_ARRAY)
+        {
+            if (task->index < task->count)
+            {
+                cStreamPush(stream, CERIAL_STREAM_TASK_FIELDS, task->plan,
+                    (void *)((size_t)task->obj + task->plan->size * task->index++), NULL);
+            }
+            else
+            {
+                stream->taskCount--;
+            }
+        }
+        else if (task->type == CERIAL_STREAM_TASK_ITEMS)
+        {
+            if (task->count)
+            {
+                task->count--;
+                if (!objListHeadAdd(&task->list, NULL))
+                {
+                    stream->result = CERIAL_ERROR_NO_MEMORY;
+                    break;
+                }
+                *task->dest = task->list.head;
+                cStreamPush(stream, CERIAL_STREAM_TASK_OBJ, task->plan, NULL,
+                    &task->list.tail->obj);
+            }
+            else
+            {
+                stream->taskCount--;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (stream->taskCount == 0 && stream->result == CERIAL_PENDING)
+    {
+        stream->result = CERIAL_OK;
+    }
+}
+
+
+/**
+ * @brief 处理需要读取数据的任务
+ * 
+ * @param stream 反序列化器
+ * @param task 任务
+ * @param data 数据，起始于数据偏移 stream->offset
+ * @param size 数据大小
+ * @return size_t 使用的数据大小
+ */
+static size_t cStreamRead(CDeserialStream *stream, CDeserialTask *task,
+                          const char *data, size_t size)
+{
+    size_t len = 0;
+    if (task->type == CERIAL_STREAM_TASK_OBJ)
+    {
+        ReflectPlan *plan = task->plan;
+        if (!task->obj)
+        {
+            task->obj = REFLECT_MALLOC(plan->size);
+            if (!task->obj)
+            {
+                stream->result = CERIAL_ERROR_NO_MEMORY;
+                return 0;
+            }
+        }
+        len = plan->alignedSize - task->index;
+        len = len < size ? len : size;
+        if (task->index < plan->size)
+        {
+            size_t copy = plan->size - task->index;
+            memcpy((char *)task->obj + task->index, data, copy < len ? copy : len);
+        }
+        task->index += len;
+        if (task->index == plan->alignedSize)
+        {
+            cStreamMark(task->obj, plan, stream->offset + len - plan->alignedSize);
+            *task->dest = task->obj;
+            task->type = CERIAL_STREAM_TASK_FIELDS;
+            task->index = 0;
+        }
+    }
+    else if (task->type == CERIAL_STREAM_TASK_VECTOR)
+    {
+        ReflectPlan *plan = task->plan;
+        size_t itemsSize = plan->size * task->count;
+        if (!task->obj)
+        {
+            task->obj = REFLECT_MALLOC(itemsSize);
+            if (!task->obj)
+            {
+                stream->result = CERIAL_ERROR_NO_MEMORY;
+                return 0;
+            }
+        }
+        len = REFLECT_ALIGN(itemsSize) - task->index;
+        len = len < size ? len : size;
+        if (task->index < itemsSize)
+        {
+            size_t copy = itemsSize - task->index;
+            memcpy((char *)task->obj + task->index, data, copy < len ? copy : len);
+        }
+        task->index += len;
+        if (task->index == REFLECT_ALIGN(itemsSize))
+        {
+            /* 元素读取完成后按数组处理各元素的字段 */
+            size_t offset = stream->offset + len - REFLECT_ALIGN(itemsSize);
+            for (size_t i = 0; i < task->count && !plan->isPlain; i++)
+            {
+                cStreamMark((char *)task->obj + plan->size * i, plan, offset + plan->size * i);
+            }
+            *task->dest = task->obj;
+            task->type = CERIAL_STREAM_TASK_ARRAY;
+            task->index = plan->isPlain ? task->count : 0;
+        }
+    }
+    else if (task->type == CERIAL_STREAM_TASK_STRING)
+    {
+        if (task->count == 0)
+        {
+            const char *end = memchr(data, 0, size);
+            len = end ? (size_t)(end - data) + 1 : size;
+            if (stream->bufferUsed + len > stream->bufferSize)
+            {
+                size_t bufferSize = stream->bufferSize ? stream->bufferSize : 64;
+                while (bufferSize < stream->bufferUsed + len)
+                {
+                    bufferSize *= 2;
+                }
+                char *buffer = REFLECT_MALLOC(bufferSize);
+                if (!buffer)
+                {
+                    stream->result = CERIAL_ERROR_NO_MEMORY;
+                    return 0;
+                }
+                if (stream->buffer)
+                {
+                    memcpy(buffer, stream->buffer, stream->bufferUsed);
+                    REFLECT_FREE(stream->buffer);
+                }
+                stream->buffer = buffer;
+                stream->bufferSize = bufferSize;
+            }
+            memcpy(stream->buffer + stream->bufferUsed, data, len);
+            stream->bufferUsed += len;
+            if (end)
+            {
+                *task->dest = reflectNewString(stream->buffer);
+                if (!*task->dest
+                    || objMapPut(&stream->strings, (void *)task->index, *task->dest) != 0)
+                {
+                    stream->result = CERIAL_ERROR_NO_MEMORY;
+                    return len;
+                }
+                task->count = 1;
+                task->index = REFLECT_ALIGN(stream->bufferUsed) - stream->bufferUsed;
+                stream->bufferUsed = 0;
+            }
+        }
+        else
+        {
+            len = task->index < size ? task->index : size;
+            task->index -= len;
+        }
+        if (task->count && task->index == 0)
+        {
+            stream->taskCount--;
+        }
+    }
+    else if (task->type == CERIAL_STREAM_TASK_NODES)
+    {
+        len = sizeof(ObjList) - task->index;
+        len = len < size ? len : size;
+        memcpy((char *)&task->node + task->index, data, len);
+        task->index += len;
+        if (task->index == sizeof(ObjList))
+        {
+            task->index = 0;
+            task->count++;
+            if (!task->node.next)
+            {
+                task->type = CERIAL_STREAM_TASK_ITEMS;
+            }
+        }
+    }
+    return len;
+}
+
+
+/**
+ * @brief 初始化流式反序列化器
+ *        数据需要按 cSerialize 的顺序排列，字符串表中的字符串可以引用之前已读取的字符串，
+ *        其他指向已读取数据的引用(CERIAL_OPTION_SHARED)作为无效数据处理
+ * 
+ * @param stream 反序列化器
+ * @param model Reflection 模型
+ * @return int CERIAL_PENDING 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cDeserialStreamInit(CDeserialStream *stream, Reflection *model)
+{
+    memset(stream, 0, sizeof(CDeserialStream));
+    stream->result = CERIAL_PENDING;
+    stream->plan = reflectCompileModel(model);
+    if (!stream->plan)
+    {
+        stream->result = CERIAL_ERROR_NO_MEMORY;
+        return stream->result;
+    }
+    cStreamPush(stream, CERIAL_STREAM_TASK_OBJ, stream->plan, NULL, &stream->obj);
+    return stream->result;
+}
+
+
+/**
+ * @brief 流式反序列化输入数据
+ *        数据可以任意分段输入，每段数据处理完成后即可返回，等待下一段数据
+ * 
+ * @param stream 反序列化器
+ * @param data 数据
+ * @param size 数据大小
+ * @param consumed 使用的数据大小，对象完成后多余的数据不会被使用，可为NULL
+ * @return int CERIAL_PENDING 需要更多数据 CERIAL_OK 对象已完成 其他 错误
+ */
+int cDeserialStreamFeed(CDeserialStream *stream, const void *data, size_t size, size_t *consumed)
+{
+    size_t used = 0;
+    if (!stream->plan)
+    {
+        /* 初始化失败或已结束的反序列化器不使用数据 */
+        if (consumed)
+        {
+            *consumed = 0;
+        }
+        return stream->result;
+    }
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, stream->plan->model, REFLECT_STATS_OP_DESERIALIZE);
+    cStreamSettle(stream);
+    while (used < size && stream->result == CERIAL_PENDING)
+    {
+        size_t len = cStreamRead(stream, &stream->tasks[stream->taskCount - 1],
+            (const char *)data + used, size - used);
+        used += len;
+        stream->offset += len;
+        cStreamSettle(stream);
+    }
+    if (consumed)
+    {
+        *consumed = used;
+    }
+    REFLECT_STATS_END(scope, used, 0);
+    return stream->result;
+}
+
+
+/**
+ * @brief 获取流式反序列化器下一步可以使用的数据大小
+ *        按此大小读取数据不会读取到序列化数据之后的内容
+ * 
+ * @param stream 反序列化器
+ * @return size_t 数据大小，对象已完成或出错时为0
+ */
+size_t cDeserialStreamWant(CDeserialStream *stream)
+{
+    cStreamSettle(stream);
+    REFLECT_ASSERT(stream->taskCount, return 0);
+    if (stream->result != CERIAL_PENDING)
+    {
+        return 0;
+    }
+    CDeserialTask *task = &stream->tasks[stream->taskCount - 1];
+    if (task->type == CERIAL_STREAM_TASK_OBJ)
+    {
+        return task->plan->alignedSize - task->index;
+    }
+    else if (task->type == CERIAL_STREAM_TASK_NODES)
+    {
+        return sizeof(ObjList) - task->index;
+    }
+    else if (task->type == CERIAL_STREAM_TASK_VECTOR)
+    {
+        return REFLECT_ALIGN(task->plan->size * task->count) - task->index;
+    }
+    else if (task->count)
+    {
+        return task->index;
+    }
+    /* 字符串以 size_t 对齐，读取到下一个对齐位置不会越过字符串数据 */
+    return sizeof(size_t) - (stream->offset & (sizeof(size_t) - 1));
+}
+
+
+/**
+ * @brief 结束流式反序列化
+ * 
+ * @param stream 反序列化器
+ * @return void* 反序列化得到的对象，对象未完成时释放已构建的部分并返回NULL
+ */
+void *cDeserialStreamFinish(CDeserialStream *stream)
+{
+    void *obj = stream->obj;
+    if (stream->result != CERIAL_OK)
+    {
+        for (size_t i = 0; i < stream->taskCount; i++)
+        {
+            CDeserialTask *task = &stream->tasks[i];
+            if ((task->type == CERIAL_STREAM_TASK_OBJ || task->type == CERIAL_STREAM_TASK_VECTOR)
+                && task->obj)
+            {
+                REFLECT_FREE(task->obj);
+            }
+        }
+        if (obj)
+        {
+            cStreamUnmark(obj, stream->plan);
+            reflectFreePlanObj(obj, stream->plan, 1);
+        }
+        obj = NULL;
+    }
+    if (stream->tasks)
+    {
+        REFLECT_FREE(stream->tasks);
+    }
+    if (stream->buffer)
+    {
+        REFLECT_FREE(stream->buffer);
+    }
+    objMapClear(&stream->strings);
+    memset(stream, 0, sizeof(CDeserialStream));
+    return obj;
+}
+
+
+/**
+ * @brief 从读函数流式反序列化
+ * 
+ * @param model Reflection 模型
+ * @param read 读函数
+ * @param context 读函数用户上下文
+ * @return void* 反序列化得到的对象，失败返回NULL
+ */
+void *cDeserializeStream(Reflection *model, CSerialRead read, void *context)
+{
+    CDeserialStream stream;
+    char buffer[CERIAL_STREAM_READ_SIZE];
+
+    cDeserialStreamInit(&stream, model);
+    while (stream.result == CERIAL_PENDING)
+    {
+        size_t want = cDeserialStreamWant(&stream);
+        long len = read(context, buffer, want < sizeof(buffer) ? want : sizeof(buffer));
+        if (len <= 0)
+        {
+            stream.result = CERIAL_ERROR_IO;
+            break;
+        }
+        cDeserialStreamFeed(&stream, buffer, len, NULL);
+    }
+    return cDeserialStreamFinish(&stream);
+}
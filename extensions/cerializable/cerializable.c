@@ -9,270 +9,1393 @@
  * 
  */
 #include "cerializable.h"
+#include "cerial_internal.h"
 #include "string.h"
 #include "obj_list.h"
+#include "obj_map.h"
+#include "str_pool.h"
+#if CERIAL_PARALLEL_ENABLE == 1
+#include "pthread.h"
+#endif
+
+
+#define CERIAL_BUFFER_MIN_SIZE      256
+#define CERIAL_STRING_MIN_CAPACITY  64
+
+/**
+ * @brief 字符串表项
+ * 
+ */
+typedef struct
+{
+    const char *str;                            /**< 字符串，NULL 表示空项 */
+    size_t offset;                              /**< 字符串数据偏移 */
+} CSerialString;
+
+/**
+ * @brief 字符串表
+ *        记录已写入的字符串内容和偏移，相同内容的字符串只写入一次
+ * 
+ */
+typedef struct
+{
+    CSerialString *entries;                     /**< 表项 */
+    size_t capacity;                            /**< 容量(2的幂) */
+    size_t size;                                /**< 字符串数量 */
+} CSerialStringTable;
+
+/**
+ * @brief 序列化写入器
+ *        数据按相对缓冲区起始的偏移写入，缓冲区扩展后地址变化不影响写入
+ * 
+ */
+typedef struct
+{
+    char *mem;                                  /**< 数据缓冲区 */
+    size_t size;                                /**< 缓冲区大小 */
+    size_t used;                                /**< 已分配的数据大小 */
+    char growable;                              /**< 缓冲区是否可扩展 */
+    int result;                                 /**< 写入结果 */
+    int threads;                                /**< 并行序列化线程数量 */
+    ObjMap *shared;                             /**< 已写入的对象偏移，为NULL时不记录共享引用 */
+    CSerialStringTable *strings;                /**< 已写入的字符串，为NULL时不合并字符串 */
+} CSerialWriter;
+
+
+/**
+ * @brief 获取对象附加数据(对象本身之后的数据)所占用的内存大小
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ * @return size_t 占用内存大小
+ */
+size_t cSerialGetExtraSize(void *obj, ReflectPlan *plan)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        if (p->isPointer)
+        {
+            if (*(void **)addr)
+            {
+                size += p->plan->alignedSize + cSerialGetExtraSize(*(void **)addr, p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            if (*(char **)addr)
+            {
+                size += REFLECT_ALIGN(strlen(*(char **)addr) + 1);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                size += cSerialGetExtraSize((void *)((size_t)addr + p->plan->size * j), p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            size += cSerialGetExtraSize(addr, p->plan);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            ObjList *list = *(ObjList **)addr;
+            size += sizeof(ObjList) * objListGetSize(list);
+            while (list)
+            {
+                size += p->plan->alignedSize + cSerialGetExtraSize(list->obj, p->plan);
+                list = list->next;
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            if (items && count)
+            {
+                size += REFLECT_ALIGN(p->plan->size * count);
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    size += cSerialGetExtraSize(items + p->plan->size * j, p->plan);
+                }
+            }
+        }
+    }
+    return size;
+}
+
+
+/**
+ * @brief 获取对象所占用的内存大小
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return size_t 占用内存大小
+ */
+size_t cSerialGetObjSize(void *obj, Reflection *model)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return 0);
+    return plan->alignedSize + cSerialGetExtraSize(obj, plan);
+}
+
+
+/**
+ * @brief 扩展写入器缓冲区
+ * 
+ * @param writer 写入器
+ * @param size 需要的最小大小
+ * @return int 0 成功 -1 内存不足
+ */
+static int cSerialGrow(CSerialWriter *writer, size_t size)
+{
+    size_t newSize = writer->size ? writer->size * 2 : CERIAL_BUFFER_MIN_SIZE;
+    while (newSize < size)
+    {
+        newSize *= 2;
+    }
+    char *mem = REFLECT_MALLOC(newSize);
+    REFLECT_ASSERT(mem, return -1);
+    if (writer->mem)
+    {
+        memcpy(mem, writer->mem, writer->used);
+        REFLECT_FREE(writer->mem);
+    }
+    writer->mem = mem;
+    writer->size = newSize;
+    return 0;
+}
+
+
+/**
+ * @brief 分配序列化数据空间
+ *        空间不足时只记录错误并继续累计大小，用于得到所需的缓冲区大小
+ * 
+ * @param writer 写入器
+ * @param size 数据大小
+ * @return size_t 分配得到的数据偏移
+ */
+static size_t cSerialAlloc(CSerialWriter *writer, size_t size)
+{
+    size_t offset = writer->used;
+    if (writer->result == CERIAL_OK && offset + size > writer->size)
+    {
+        if (!writer->growable)
+        {
+            writer->result = CERIAL_ERROR_NO_SPACE;
+        }
+        else if (cSerialGrow(writer, offset + size) != 0)
+        {
+            writer->result = CERIAL_ERROR_NO_MEMORY;
+        }
+    }
+    writer->used = offset + size;
+    return offset;
+}
+
+
+/**
+ * @brief 写入数据，并将对齐填充部分置0
+ * 
+ * @param writer 写入器
+ * @param offset 写入偏移
+ * @param data 数据
+ * @param size 数据大小
+ * @param alignedSize 对齐后的数据大小
+ */
+static void cSerialWrite(CSerialWriter *writer, size_t offset,
+                         const void *data, size_t size, size_t alignedSize)
+{
+    if (writer->result == CERIAL_OK)
+    {
+        memcpy(writer->mem + offset, data, size);
+        memset(writer->mem + offset + size, 0, alignedSize - size);
+    }
+}
+
+
+/**
+ * @brief 写入字段的相对偏移
+ * 
+ * @param writer 写入器
+ * @param fieldOffset 字段偏移
+ * @param dataOffset 字段指向的数据偏移
+ */
+static void cSerialWriteOffset(CSerialWriter *writer, size_t fieldOffset, size_t dataOffset)
+{
+    if (writer->result == CERIAL_OK)
+    {
+        *(size_t *)(writer->mem + fieldOffset) = dataOffset - fieldOffset;
+    }
+}
+
+
+/**
+ * @brief 字符串表扩容
+ * 
+ * @param table 字符串表
+ * @return int 0 成功 -1 内存不足
+ */
+static int cSerialStringGrow(CSerialStringTable *table)
+{
+    size_t capacity = table->capacity ? table->capacity * 2 : CERIAL_STRING_MIN_CAPACITY;
+    CSerialString *entries = REFLECT_MALLOC(sizeof(CSerialString) * capacity);
+    REFLECT_ASSERT(entries, return -1);
+    memset(entries, 0, sizeof(CSerialString) * capacity);
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        if (table->entries[i].str)
+        {
+            size_t index = strPoolHash(table->entries[i].str, strlen(table->entries[i].str))
+                & (capacity - 1);
+            while (entries[index].str)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+            entries[index] = table->entries[i];
+        }
+    }
+    if (table->entries)
+    {
+        REFLECT_FREE(table->entries);
+    }
+    table->entries = entries;
+    table->capacity = capacity;
+    return 0;
+}
+
+
+/**
+ * @brief 写入字符串
+ *        使用字符串表时，相同内容的字符串只写入一次，之后直接返回已写入的偏移
+ * 
+ * @param writer 写入器
+ * @param str 字符串
+ * @return size_t 字符串数据偏移
+ */
+static size_t cSerialPutString(CSerialWriter *writer, const char *str)
+{
+    size_t len = strlen(str) + 1;
+    CSerialStringTable *table = writer->strings;
+    CSerialString *entry = NULL;
+    if (table)
+    {
+        if ((table->size + 1) * 4 > table->capacity * 3 && cSerialStringGrow(table) != 0)
+        {
+            writer->result = CERIAL_ERROR_NO_MEMORY;
+            return 0;
+        }
+        size_t index = strPoolHash(str, len - 1) & (table->capacity - 1);
+        while (table->entries[index].str)
+        {
+            if (strcmp(table->entries[index].str, str) == 0)
+            {
+                return table->entries[index].offset;
+            }
+            index = (index + 1) & (table->capacity - 1);
+        }
+        entry = &table->entries[index];
+    }
+    size_t offset = cSerialAlloc(writer, REFLECT_ALIGN(len));
+    cSerialWrite(writer, offset, str, len, REFLECT_ALIGN(len));
+    if (entry)
+    {
+        entry->str = str;
+        entry->offset = offset;
+        table->size++;
+    }
+    return offset;
+}
+
+
+static size_t cSerialPutObj(CSerialWriter *writer, void *obj, ReflectPlan *plan);
+
+/**
+ * @brief 序列化引用的对象
+ *        记录共享引用时，已经写入的对象直接返回其偏移
+ * 
+ * @param writer 写入器
+ * @param obj 对象
+ * @param plan 执行计划
+ * @return size_t 序列化对象偏移
+ */
+static size_t cSerialPutRef(CSerialWriter *writer, void *obj, ReflectPlan *plan)
+{
+    if (writer->shared)
+    {
+        ObjMapEntry *entry = objMapFind(writer->shared, obj);
+        if (entry)
+        {
+            return (size_t)entry->value;
+        }
+    }
+    return cSerialPutObj(writer, obj, plan);
+}
+
+#if CERIAL_PARALLEL_ENABLE == 1
+/**
+ * @brief 并行序列化任务
+ *        每个线程处理链表中连续的一段对象
+ * 
+ */
+typedef struct
+{
+    CSerialWriter *writer;                      /**< 写入器 */
+    void **items;                               /**< 链表对象 */
+    size_t count;                               /**< 链表对象数量 */
+    size_t *offsets;                            /**< 对象大小，前缀和之后为对象偏移 */
+    size_t begin;                               /**< 起始序号 */
+    size_t end;                                 /**< 结束序号 */
+    size_t nodeOffset;                          /**< 链表节点数组偏移 */
+    ReflectPlan *plan;                          /**< 对象执行计划 */
+} CSerialTask;
+
+
+/**
+ * @brief 并行计算对象大小
+ * 
+ * @param arg 任务
+ * @return void* NULL
+ */
+static void *cSerialTaskSize(void *arg)
+{
+    CSerialTask *task = arg;
+    for (size_t i = task->begin; i < task->end; i++)
+    {
+        task->offsets[i] = task->plan->alignedSize
+            + cSerialGetExtraSize(task->items[i], task->plan);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief 并行写入对象和链表节点
+ *        数据空间已经预先分配，各线程写入的区域互不重叠
+ * 
+ * @param arg 任务
+ * @return void* NULL
+ */
+static void *cSerialTaskWrite(void *arg)
+{
+    CSerialTask *task = arg;
+    CSerialWriter writer = {task->writer->mem, task->writer->size, 0, 0, CERIAL_OK, 0, NULL, NULL};
+    for (size_t i = task->begin; i < task->end; i++)
+    {
+        ObjList node;
+        size_t nodeOffset = task->nodeOffset + sizeof(ObjList) * i;
+        writer.used = task->offsets[i];
+        cSerialPutObj(&writer, task->items[i], task->plan);
+        node.obj = (void *)(task->offsets[i] - (nodeOffset + offsetof(ObjList, obj)));
+        node.next = i + 1 < task->count ? (ObjList *)sizeof(ObjList) : 0;
+        cSerialWrite(&writer, nodeOffset, &node, sizeof(ObjList), sizeof(ObjList));
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief 多线程执行任务
+ *        线程创建失败时由当前线程执行对应的任务
+ * 
+ * @param tasks 任务
+ * @param count 任务数量
+ * @param routine 任务函数
+ */
+static void cSerialRunTasks(CSerialTask *tasks, size_t count, void *(*routine)(void *))
+{
+    pthread_t threads[CERIAL_PARALLEL_MAX_THREADS];
+    char created[CERIAL_PARALLEL_MAX_THREADS];
+    for (size_t i = 1; i < count; i++)
+    {
+        created[i] = pthread_create(&threads[i], NULL, routine, &tasks[i]) == 0;
+    }
+    routine(&tasks[0]);
+    for (size_t i = 1; i < count; i++)
+    {
+        if (created[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            routine(&tasks[i]);
+        }
+    }
+}
+
+
+/**
+ * @brief 并行序列化链表
+ *        并行计算各对象的大小，通过前缀和得到对象偏移，一次分配所有对象的空间后并行写入，
+ *        得到的数据与串行序列化完全一致
+ * 
+ * @param writer 写入器
+ * @param list 链表
+ * @param listSize 链表大小
+ * @param fieldOffset 链表字段偏移
+ * @param plan 对象执行计划
+ * @return int 0 成功 -1 内存不足(未写入任何数据，需要串行序列化)
+ */
+static int cSerialPutListParallel(CSerialWriter *writer, ObjList *list, size_t listSize,
+                                  size_t fieldOffset, ReflectPlan *plan)
+{
+    CSerialTask tasks[CERIAL_PARALLEL_MAX_THREADS];
+    size_t count = writer->threads < CERIAL_PARALLEL_MAX_THREADS
+        ? writer->threads : CERIAL_PARALLEL_MAX_THREADS;
+    void **items = REFLECT_MALLOC((sizeof(void *) + sizeof(size_t)) * listSize);
+    REFLECT_ASSERT(items, return -1);
+    size_t *offsets = (size_t *)(items + listSize);
+    for (size_t i = 0; list; i++, list = list->next)
+    {
+        items[i] = list->obj;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        tasks[i].writer = writer;
+        tasks[i].items = items;
+        tasks[i].count = listSize;
+        tasks[i].offsets = offsets;
+        tasks[i].begin = listSize * i / count;
+        tasks[i].end = listSize * (i + 1) / count;
+        tasks[i].plan = plan;
+    }
+    cSerialRunTasks(tasks, count, cSerialTaskSize);
+
+    size_t nodeOffset = cSerialAlloc(writer, sizeof(ObjList) * listSize);
+    cSerialWriteOffset(writer, fieldOffset, nodeOffset);
+    size_t offset = writer->used;
+    for (size_t i = 0; i < listSize; i++)
+    {
+        size_t size = offsets[i];
+        offsets[i] = offset;
+        offset += size;
+    }
+    cSerialAlloc(writer, offset - writer->used);
+
+    if (writer->result == CERIAL_OK)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            tasks[i].nodeOffset = nodeOffset;
+        }
+        cSerialRunTasks(tasks, count, cSerialTaskWrite);
+    }
+    REFLECT_FREE(items);
+    return 0;
+}
+#endif
+
+/**
+ * @brief 序列化对象字段
+ *        对象本身已经写入，依次写入字段指向的数据并修正字段为相对偏移
+ * 
+ * @param writer 写入器
+ * @param obj 对象
+ * @param objOffset 序列化对象偏移
+ * @param plan 执行计划
+ */
+static void cSerialPutFields(CSerialWriter *writer, void *obj, size_t objOffset, ReflectPlan *plan)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        size_t fieldOffset = objOffset + p->offset;
+        if (p->isPointer)
+        {
+            if (*(void **)addr)
+            {
+                cSerialWriteOffset(writer, fieldOffset,
+                    cSerialPutRef(writer, *(void **)addr, p->plan));
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            if (*(char **)addr)
+            {
+                cSerialWriteOffset(writer, fieldOffset, cSerialPutString(writer, *(char **)addr));
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                cSerialPutFields(writer,
+                    (void *)((size_t)addr + p->plan->size * j),
+                    fieldOffset + p->plan->size * j,
+                    p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            cSerialPutFields(writer, addr, fieldOffset, p->plan);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            ObjList *list = *(ObjList **)addr;
+            size_t listSize = objListGetSize(list);
+#if CERIAL_PARALLEL_ENABLE == 1
+            if (writer->threads > 1 && listSize >= CERIAL_PARALLEL_MIN_ITEMS
+                && cSerialPutListParallel(writer, list, listSize, fieldOffset, p->plan) == 0)
+            {
+                continue;
+            }
+#endif
+            if (listSize != 0)
+            {
+                size_t nodeOffset = cSerialAlloc(writer, sizeof(ObjList) * listSize);
+                cSerialWriteOffset(writer, fieldOffset, nodeOffset);
+                while (list)
+                {
+                    ObjList node;
+                    size_t itemOffset = cSerialPutRef(writer, list->obj, p->plan);
+                    node.obj = (void *)(itemOffset - (nodeOffset + offsetof(ObjList, obj)));
+                    node.next = list->next ? (ObjList *)sizeof(ObjList) : 0;
+                    cSerialWrite(writer, nodeOffset, &node, sizeof(ObjList), sizeof(ObjList));
+                    nodeOffset += sizeof(ObjList);
+                    list = list->next;
+                }
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            if (items && count)
+            {
+                /* 元素连续存储，整体写入后再处理各元素中的指针字段 */
+                size_t size = p->plan->size * count;
+                size_t itemsOffset = cSerialAlloc(writer, REFLECT_ALIGN(size));
+                cSerialWrite(writer, itemsOffset, items, size, REFLECT_ALIGN(size));
+                cSerialWriteOffset(writer, fieldOffset, itemsOffset);
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    cSerialPutFields(writer, items + p->plan->size * j,
+                        itemsOffset + p->plan->size * j, p->plan);
+                }
+            }
+            else if (items)
+            {
+                /* 元素数量为0时按空指针记录 */
+                cSerialWriteOffset(writer, fieldOffset, fieldOffset);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief 序列化对象
+ * 
+ * @param writer 写入器
+ * @param obj 对象
+ * @param plan 执行计划
+ * @return size_t 序列化对象偏移
+ */
+static size_t cSerialPutObj(CSerialWriter *writer, void *obj, ReflectPlan *plan)
+{
+    REFLECT_STATS_ENTER();
+    size_t offset = cSerialAlloc(writer, plan->alignedSize);
+    cSerialWrite(writer, offset, obj, plan->size, plan->alignedSize);
+    /* 写入字段之前记录对象，循环引用时指向已分配的偏移 */
+    if (writer->shared && objMapPut(writer->shared, obj, (void *)offset) != 0)
+    {
+        writer->result = CERIAL_ERROR_NO_MEMORY;
+    }
+    cSerialPutFields(writer, obj, offset, plan);
+    REFLECT_STATS_LEAVE();
+    return offset;
+}
+
+
+/**
+ * @brief 结束可扩展写入器的序列化，得到按数据大小分配的结果
+ *        缓冲区按倍数扩展，返回前复制到与数据大小一致的内存中，失败时释放缓冲区
+ * 
+ * @param writer 写入器
+ * @param size 序列化后的数据大小
+ * @return void* 序列化得到的数据地址，失败返回NULL
+ */
+static void *cSerialFinish(CSerialWriter *writer, size_t *size)
+{
+    if (writer->result != CERIAL_OK)
+    {
+        if (writer->mem)
+        {
+            REFLECT_FREE(writer->mem);
+        }
+        return NULL;
+    }
+    char *mem = writer->mem;
+    if (writer->size > writer->used)
+    {
+        /* 内存不足时保留原缓冲区，数据仍然有效 */
+        char *exact = REFLECT_MALLOC(writer->used);
+        if (exact)
+        {
+            memcpy(exact, mem, writer->used);
+            REFLECT_FREE(mem);
+            mem = exact;
+        }
+    }
+    *size = writer->used;
+    return mem;
+}
+
+
+/**
+ * @brief 序列化
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param size 序列化后的数据大小
+ * @return void* 序列化得到的数据地址
+ */
+void *cSerialize(void *obj, Reflection *model, size_t *size)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    /* 缓冲区按需扩展，不预先遍历对象计算大小，每个链表只在写入时计数一次，结束时复制为精确大小 */
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    CSerialWriter writer = {NULL, 0, 0, 1, CERIAL_OK, 0, NULL, NULL};
+    cSerialPutObj(&writer, obj, plan);
+    void *mem = cSerialFinish(&writer, size);
+    REFLECT_STATS_END(scope, 0, mem ? writer.used : 0);
+    return mem;
+}
+
+
+/**
+ * @brief 并行序列化
+ *        元素数量不少于 CERIAL_PARALLEL_MIN_ITEMS 的链表使用多线程序列化，
+ *        得到的数据与 cSerialize 完全一致
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param size 序列化后的数据大小
+ * @param threads 线程数量，不大于1或者未使能 CERIAL_PARALLEL_ENABLE 时串行序列化
+ * @return void* 序列化得到的数据地址
+ */
+void *cSerializeParallel(void *obj, Reflection *model, size_t *size, int threads)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    /* 缓冲区按需扩展，串行部分不需要预先计算大小，链表对象的大小只计算一次 */
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    CSerialWriter writer = {NULL, 0, 0, 1, CERIAL_OK, threads, NULL, NULL};
+    cSerialPutObj(&writer, obj, plan);
+    void *mem = cSerialFinish(&writer, size);
+    REFLECT_STATS_END(scope, 0, mem ? writer.used : 0);
+    return mem;
+}
 
 
 /**
- * @brief 获取对象所占用的内存大小
+ * @brief 按选项序列化
+ *        CERIAL_OPTION_SHARED 记录已写入的对象，被多处引用的子对象和链表对象只写入一次，
+ *        其他引用写入指向同一份数据的相对偏移，对象之间可以存在循环引用，
+ *        CERIAL_OPTION_STRING_TABLE 记录已写入的字符串，相同内容的字符串只写入一次
  * 
  * @param obj 对象
  * @param model Reflection 模型
- * @return size_t 占用内存大小
+ * @param size 序列化后的数据大小
+ * @param options 序列化选项，CERIAL_OPTION_SHARED，CERIAL_OPTION_STRING_TABLE 的组合
+ * @return void* 序列化得到的数据地址
+ * @note 数据可以直接使用 cView 系列接口访问，只使用 CERIAL_OPTION_STRING_TABLE 时，
+ *       数据可以使用 cDeserialize 和流式反序列化接口反序列化，
+ *       使用 CERIAL_OPTION_SHARED 时，反序列化需要使用 cDeserializeShared，
+ *       流式反序列化接口遇到共享引用时返回 CERIAL_ERROR_INVALID
  */
-size_t cSerialGetObjSize(void *obj, Reflection *model)
+void *cSerializeEx(void *obj, Reflection *model, size_t *size, int options)
 {
-    Reflection *p = model;
-    size_t size = 0;
-    while (p->type != REFLECT_TYPE_OBJ)
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    /* 共享的对象和字符串只写入一次，无法预先计算大小，缓冲区按需扩展 */
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    ObjMap shared = {0};
+    CSerialStringTable strings = {0};
+    CSerialWriter writer = {NULL, 0, 0, 1, CERIAL_OK, 0,
+        (options & CERIAL_OPTION_SHARED) ? &shared : NULL,
+        (options & CERIAL_OPTION_STRING_TABLE) ? &strings : NULL};
+    cSerialPutObj(&writer, obj, plan);
+    objMapClear(&shared);
+    if (strings.entries)
+    {
+        REFLECT_FREE(strings.entries);
+    }
+    void *mem = cSerialFinish(&writer, size);
+    REFLECT_STATS_END(scope, 0, mem ? writer.used : 0);
+    return mem;
+}
+
+
+/**
+ * @brief 共享引用序列化
+ *        被多处引用的子对象和链表对象只写入一次，对象之间可以存在循环引用
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param size 序列化后的数据大小
+ * @return void* 序列化得到的数据地址
+ * @note 数据格式与 cSerialize 相同，可以直接使用 cView 系列接口访问，
+ *       反序列化需要使用 cDeserializeShared
+ */
+void *cSerializeShared(void *obj, Reflection *model, size_t *size)
+{
+    return cSerializeEx(obj, model, size, CERIAL_OPTION_SHARED);
+}
+
+
+/**
+ * @brief 序列化到指定的缓冲区
+ *        单次遍历对象，直接写入缓冲区，不分配内存
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buf 缓冲区，需要按 size_t 对齐
+ * @param cap 缓冲区大小
+ * @param used 序列化后的数据大小，缓冲区空间不足时为所需的缓冲区大小
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_SPACE 缓冲区空间不足
+ */
+int cSerializeInto(void *obj, Reflection *model, void *buf, size_t cap, size_t *used)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    CSerialWriter writer = {buf, cap, 0, 0, CERIAL_OK, 0, NULL, NULL};
+    cSerialPutObj(&writer, obj, plan);
+    *used = writer.used;
+    REFLECT_STATS_END(scope, 0, writer.result == CERIAL_OK ? writer.used : 0);
+    return writer.result;
+}
+
+
+/**
+ * @brief 序列化到可扩展的缓冲区
+ *        数据追加在 buffer->used 之后(按 size_t 对齐)，空间不足时自动扩展缓冲区
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeToBuffer(void *obj, Reflection *model, CSerialBuffer *buffer)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    CSerialWriter writer = {buffer->mem, buffer->size, REFLECT_ALIGN(buffer->used), 1, CERIAL_OK, 0, NULL, NULL};
+    cSerialPutObj(&writer, obj, plan);
+    REFLECT_STATS_END(scope, 0, writer.result == CERIAL_OK ? writer.used - REFLECT_ALIGN(buffer->used) : 0);
+    buffer->mem = writer.mem;
+    buffer->size = writer.size;
+    if (writer.result == CERIAL_OK)
+    {
+        buffer->used = writer.used;
+    }
+    return writer.result;
+}
+
+
+/**
+ * @brief 批量序列化
+ *        所有对象写入同一块连续的数据，数据起始为对象数量和各对象的偏移索引，
+ *        执行计划和缓冲区在整批对象间复用，每个对象的数据与 cSerialize 格式一致
+ * 
+ * @param objs 对象数组
+ * @param count 对象数量
+ * @param model Reflection 模型
+ * @param buffer 缓冲区，数据追加在 buffer->used 之后(按 size_t 对齐)，空间不足时自动扩展
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeBatch(void *objs, size_t count, Reflection *model, CSerialBuffer *buffer)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CERIAL_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_SERIALIZE);
+    CSerialWriter writer = {buffer->mem, buffer->size, REFLECT_ALIGN(buffer->used), 1, CERIAL_OK, 0, NULL, NULL};
+    size_t base = writer.used;
+    cSerialAlloc(&writer, sizeof(size_t) * (count + 1));
+    if (writer.result == CERIAL_OK)
+    {
+        *(size_t *)(writer.mem + base) = count;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t offset = cSerialPutObj(&writer, (void *)((size_t)objs + plan->size * i), plan);
+        if (writer.result == CERIAL_OK)
+        {
+            ((size_t *)(writer.mem + base))[i + 1] = offset - base;
+        }
+    }
+    buffer->mem = writer.mem;
+    buffer->size = writer.size;
+    if (writer.result == CERIAL_OK)
+    {
+        buffer->used = writer.used;
+    }
+    REFLECT_STATS_END(scope, 0, writer.result == CERIAL_OK ? writer.used - base : 0);
+    return writer.result;
+}
+
+
+/**
+ * @brief 释放可扩展缓冲区
+ * 
+ * @param buffer 缓冲区
+ */
+void cSerialBufferFree(CSerialBuffer *buffer)
+{
+    if (buffer->mem)
+    {
+        REFLECT_FREE(buffer->mem);
+    }
+    buffer->mem = NULL;
+    buffer->size = 0;
+    buffer->used = 0;
+}
+
+
+/**
+ * @brief 反序列化上下文
+ * 
+ */
+typedef struct
+{
+    ObjMap *shared;                             /**< 已反序列化的对象，为NULL时不记录共享引用 */
+    StrPool *pool;                              /**< 字符串池，为NULL时字符串单独分配 */
+    int failed;                                 /**< 内存不足，部分字段未能反序列化 */
+} CDeserialContext;
+
+static void *cDeserialObj(void *mem, ReflectPlan *plan, void *obj, CDeserialContext *ctx);
+
+/**
+ * @brief 反序列化引用的对象
+ *        记录共享引用时，同一份数据只反序列化一次
+ * 
+ * @param mem 序列化对象地址
+ * @param plan 执行计划
+ * @param ctx 反序列化上下文
+ * @return void* 反序列化得到的对象
+ */
+static void *cDeserialRef(void *mem, ReflectPlan *plan, CDeserialContext *ctx)
+{
+    if (ctx->shared)
+    {
+        ObjMapEntry *entry = objMapFind(ctx->shared, mem);
+        if (entry)
+        {
+            return entry->value;
+        }
+    }
+    REFLECT_STATS_ENTER();
+    void *obj = cDeserialObj(mem, plan, NULL, ctx);
+    REFLECT_STATS_LEAVE();
+    return obj;
+}
+
+
+/**
+ * @brief 反序列化对象
+ * 
+ * @param mem 序列化数据地址
+ * @param plan 执行计划
+ * @param obj 对象
+ * @param ctx 反序列化上下文，内存不足时设置 failed
+ * @return void* 反序列化得到的对象
+ */
+static void *cDeserialObj(void *mem, ReflectPlan *plan, void *obj, CDeserialContext *ctx)
+{
+    if (obj == NULL)
+    {
+        obj = REFLECT_MALLOC(plan->size);
+        if (!obj)
+        {
+            ctx->failed = 1;
+            return NULL;
+        }
+        memcpy(obj, mem, plan->size);
+        /* 反序列化字段之前记录对象，循环引用时指向同一个对象 */
+        if (ctx->shared && objMapPut(ctx->shared, mem, obj) != 0)
+        {
+            REFLECT_FREE(obj);
+            ctx->failed = 1;
+            return NULL;
+        }
+    }
+
+    for (size_t i = 0; i < plan->fieldCount; i++)
     {
+        ReflectPlanField *p = &plan->fields[i];
+        size_t memField = (size_t)mem + p->offset;
+        void *addr = (void *)((size_t)obj + p->offset);
         if (p->isPointer)
         {
-            size += cSerialGetObjSize((void *)(*(size_t *)((size_t)obj + p->offset)), p->model);
+            *(void **)addr = *(size_t *)memField == 0 ? NULL : cDeserialRef(
+                (void *)(*(size_t *)memField + memField), p->plan, ctx);
         }
         else if (p->type == REFLECT_TYPE_STRING)
-        {
-            size += (strlen((char *)(*(size_t *)((size_t)obj + p->offset))) + sizeof(size_t)) & (~(sizeof(size_t) - 1));
+        {   
+            char *str = *(size_t *)memField == 0 ? NULL : (char *)(*(size_t *)memField + memField);
+            *(char **)addr = !str ? NULL
+                : ctx->pool ? (char *)strPoolIntern(ctx->pool, str)
+                : reflectNewString(str);
+            if (str && !*(char **)addr)
+            {
+                ctx->failed = 1;
+            }
         }
         else if (p->type == REFLECT_TYPE_ARRAY)
         {
-            size_t itemSize = reflectGetObjSize(p->model);
-            for (size_t i = 0; i < p->size; i++)
+            for (size_t j = 0; j < p->count; j++)
             {
-                size += cSerialGetObjSize(
-                    (void *)((size_t)obj + p->offset + itemSize * i),
-                    p->model) - itemSize;
+                cDeserialObj(
+                   (void *)(memField + p->plan->size * j),
+                   p->plan,
+                   (void *)((size_t)addr + p->plan->size * j),
+                   ctx);
             }
         }
         else if (p->type == REFLECT_TYPE_STRUCT)
         {
-            size += cSerialGetObjSize(
-                (void *)((size_t)obj + p->offset),
-                p->model) - reflectGetObjSize(p->model);
+            cDeserialObj((void *)memField, p->plan, addr, ctx);
         }
         else if (p->type == REFLECT_TYPE_LIST)
         {
-            ObjList *list = (ObjList *)(*(size_t *)((size_t)obj + p->offset));
-            size_t listSize = objListGetSize(list);
-            size += sizeof(ObjList) * listSize;
-            while (list)
+            ObjListHead items = {0};
+            if (*(size_t *)memField != 0)
             {
-                size += cSerialGetObjSize(list->obj, p->model);
-                list = list->next;
+                ObjList *list = (ObjList *)(*(size_t *)memField + memField);
+                do {
+                    void *item = cDeserialRef(
+                        (void *)((size_t)(&(list->obj)) + (size_t)list->obj),
+                        p->plan,
+                        ctx);
+                    if (!objListHeadAdd(&items, item))
+                    {
+                        /* 共享的对象可能被其他字段引用，由释放部分对象时统一处理 */
+                        ctx->failed = 1;
+                        if (item && !ctx->shared)
+                        {
+                            reflectFreePlanObj(item, p->plan, 1);
+                        }
+                    }
+                } while ((list++)->next);
+            }
+            *(ObjList **)addr = items.head;
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            size_t count = *(size_t *)((size_t)obj + p->countOffset);
+            char *items = NULL;
+            if (*(size_t *)memField != 0)
+            {
+                char *memItems = (char *)(*(size_t *)memField + memField);
+                items = REFLECT_MALLOC(p->plan->size * count);
+                if (!items)
+                {
+                    /* 元素指针为NULL即为空动态数组，其余字段继续反序列化，保证对象可以释放 */
+                    ctx->failed = 1;
+                    count = 0;
+                }
+                else
+                {
+                    memcpy(items, memItems, p->plan->size * count);
+                }
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    cDeserialObj(memItems + p->plan->size * j, p->plan,
+                                 items + p->plan->size * j, ctx);
+                }
             }
+            *(char **)addr = items;
         }
-        p++;
     }
+    return obj;
+}
 
-    size += (p->size + sizeof(size_t) - 1) & (~(sizeof(size_t) - 1));
-    return size;
+
+/**
+ * @brief 反序列化
+ * 
+ * @param mem 序列化数据地址
+ * @param model Reflection 模型
+ * @return void* 反序列化得到的对象，内存不足返回NULL
+ */
+void *cDeserialize(void *mem, Reflection *model)
+{
+    return cDeserializeEx(mem, model, 0, NULL);
 }
 
 
 /**
- * @brief 序列化对象
+ * @brief 按选项反序列化
+ *        CERIAL_OPTION_SHARED 将指向同一份数据的引用反序列化为同一个对象，保留对象之间的共享和循环引用，
+ *        指定字符串池时，字符串驻留到字符串池中，相同内容的字符串只保存一份
  * 
- * @param obj 对象
- * @param objAddr 序列化对象地址
- * @param memAddr 当前可写数据的内存地址
+ * @param mem 序列化数据地址
  * @param model Reflection 模型
- * @param isPointer 对象是否为指针形式
- * @return size_t 占用空间大小
+ * @param options 反序列化选项，CERIAL_OPTION_SHARED
+ * @param pool 字符串池，为NULL时字符串单独分配
+ * @return void* 反序列化得到的对象，内存不足返回NULL
+ * @note 对象使用 reflectFreeObjOpt 释放，使用 CERIAL_OPTION_SHARED 时需要 REFLECT_FREE_SHARED 选项，
+ *       指定字符串池时需要 REFLECT_FREE_KEEP_STRINGS 选项，字符串在字符串池清空前有效且不能修改
  */
-static size_t cSerialObj(void *obj, size_t objAddr, size_t memAddr,
-                        Reflection *model, char isPointer)
+void *cDeserializeEx(void *mem, Reflection *model, int options, StrPool *pool)
 {
-    void *startAddr = (void *)memAddr;
-    size_t size = reflectGetObjSize(model);
-    memcpy((void *)objAddr, obj, size);
-    if (isPointer)
+    REFLECT_ASSERT(mem, return NULL);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_DESERIALIZE);
+    ObjMap shared = {0};
+    CDeserialContext ctx = {(options & CERIAL_OPTION_SHARED) ? &shared : NULL, pool, 0};
+    void *obj = cDeserialRef(mem, plan, &ctx);
+    objMapClear(&shared);
+    if (ctx.failed && obj)
     {
-        memAddr += (size + sizeof(size_t) - 1) & (~(sizeof(size_t) - 1));
+        /* 内存不足时释放已反序列化的部分对象，不返回不完整的对象 */
+        reflectFreeObjOpt(obj, model,
+            ((options & CERIAL_OPTION_SHARED) ? REFLECT_FREE_SHARED : 0)
+            | (pool ? REFLECT_FREE_KEEP_STRINGS : 0));
+        obj = NULL;
     }
+    REFLECT_STATS_END(scope, 0, 0);
+    return obj;
+}
+
+
+/**
+ * @brief 共享引用反序列化
+ *        指向同一份数据的引用反序列化为同一个对象，保留对象之间的共享和循环引用
+ * 
+ * @param mem 序列化数据地址
+ * @param model Reflection 模型
+ * @return void* 反序列化得到的对象
+ * @note 对象使用 reflectFreeShared 释放
+ */
+void *cDeserializeShared(void *mem, Reflection *model)
+{
+    return cDeserializeEx(mem, model, CERIAL_OPTION_SHARED, NULL);
+}
 
-    Reflection *p = model;
-    while (p->type != REFLECT_TYPE_OBJ)
+
+/**
+ * @brief 原地反序列化对象(将相对偏移转换为指针)
+ * 
+ * @param mem 序列化对象地址
+ * @param plan 执行计划
+ */
+static void cDeserialSwizzle(void *mem, ReflectPlan *plan)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
     {
+        ReflectPlanField *p = &plan->fields[i];
+        size_t *field = (size_t *)((size_t)mem + p->offset);
         if (p->isPointer)
         {
-            *(size_t *)((size_t)objAddr + p->offset) = memAddr - ((size_t)objAddr + p->offset);
-            memAddr += cSerialObj(
-                (void *)(*(size_t *)((size_t)obj + p->offset)),
-                memAddr,
-                memAddr,
-                p->model,
-                1);
+            if (*field != 0)
+            {
+                *field += (size_t)field;
+                cDeserialSwizzle((void *)*field, p->plan);
+            }
         }
         else if (p->type == REFLECT_TYPE_STRING)
         {
-            *(size_t *)((size_t)objAddr + p->offset) = memAddr - ((size_t)objAddr + p->offset);
-            strcpy((char *)memAddr, (char *)(*(size_t *)((size_t)obj + p->offset)));
-            memAddr += (strlen((char *)(*(size_t *)((size_t)obj + p->offset))) + sizeof(size_t))
-                & (~(sizeof(size_t) - 1));
+            if (*field != 0)
+            {
+                *field += (size_t)field;
+            }
         }
         else if (p->type == REFLECT_TYPE_ARRAY)
         {
-            size_t itemSize = reflectGetObjSize(p->model);
-            for (size_t i = 0; i < p->size; i++)
+            for (size_t j = 0; j < p->count; j++)
             {
-                memAddr += cSerialObj(
-                    (void *)((size_t)obj + p->offset + itemSize * i),
-                    (size_t)objAddr + p->offset + itemSize * i,
-                    memAddr,
-                    p->model,
-                    0);
+                cDeserialSwizzle((void *)((size_t)field + p->plan->size * j), p->plan);
             }
         }
         else if (p->type == REFLECT_TYPE_STRUCT)
         {
-            memAddr += cSerialObj(
-                (void *)((size_t)obj + p->offset),
-                (size_t)objAddr + p->offset,
-                memAddr,
-                p->model,
-                0);
+            cDeserialSwizzle(field, p->plan);
         }
         else if (p->type == REFLECT_TYPE_LIST)
         {
-            ObjList *list = (ObjList *)(*(size_t *)((size_t)obj + p->offset));
-            size_t listSize = objListGetSize(list);
-            if (listSize == 0)
+            if (*field != 0)
             {
-                *(size_t *)((size_t)objAddr + p->offset) = 0;
+                ObjList *list = (ObjList *)(*field + (size_t)field);
+                *field = (size_t)list;
+                do {
+                    list->obj = (void *)((size_t)(&(list->obj)) + (size_t)list->obj);
+                    list->next = list->next ? list + 1 : NULL;
+                    cDeserialSwizzle(list->obj, p->plan);
+                } while ((list++)->next);
             }
-            else
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            if (*field != 0)
             {
-                *(size_t *)((size_t)objAddr + p->offset) 
-                    = memAddr - ((size_t)objAddr + p->offset);
-                ObjList *listObj = (ObjList *)memAddr;
-                memAddr += sizeof(ObjList) * listSize;
-                while (list)
+                size_t count = *(size_t *)((size_t)mem + p->countOffset);
+                *field += (size_t)field;
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
                 {
-                    listObj->obj = (void *)(memAddr - (size_t)(&(listObj->obj)));
-                    listObj->next = list->next ? (ObjList *)sizeof(ObjList) : 0;
-                    memAddr += cSerialObj(
-                        list->obj,
-                        memAddr,
-                        memAddr,
-                        p->model,
-                        1);
-                    listObj ++;
-                    list = list->next;
+                    cDeserialSwizzle((void *)(*field + p->plan->size * j), p->plan);
                 }
             }
         }
-        p++;
     }
-    return memAddr - (size_t)startAddr;
 }
 
 
 /**
- * @brief 序列化
+ * @brief 原地反序列化
+ *        直接将序列化数据中的相对偏移转换为指针，不分配内存
  * 
- * @param obj 对象
+ * @param mem 序列化数据地址
  * @param model Reflection 模型
- * @param size 序列化后的数据大小
- * @return void* 序列化得到的数据地址
+ * @return void* 反序列化得到的对象，即 mem 本身
+ * @note 序列化数据被原地修改，只能原地反序列化一次，
+ *       对象的所有数据都位于 mem 中，使用 reflectFreeMem(mem) 释放，
+ *       不能使用 reflectFreeObj 释放，也不能修改对象的字符串，链表等字段
  */
-void *cSerialize(void *obj, Reflection *model, size_t *size)
+void *cDeserializeInPlace(void *mem, Reflection *model)
 {
-    *size = cSerialGetObjSize(obj, model);
-    void *mem = REFLECT_MALLOC(*size);
     REFLECT_ASSERT(mem, return NULL);
-    cSerialObj(obj, (size_t)mem, (size_t)mem, model, 1);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_DESERIALIZE);
+    cDeserialSwizzle(mem, plan);
+    REFLECT_STATS_END(scope, 0, 0);
     return mem;
 }
 
 
 /**
- * @brief 反序列化对象
+ * @brief 获取序列化对象数据的结束地址
  * 
- * @param mem 序列化数据地址
- * @param model Reflection 模型
- * @param obj 对象
- * @return void* 反序列化得到的对象
+ * @param mem 序列化对象地址
+ * @param plan 执行计划
+ * @param end 当前已知的结束地址
+ * @return size_t 结束地址
  */
-static void *cDeserialObj(void *mem, Reflection *model, void *obj)
+static size_t cDeserialGetEnd(void *mem, ReflectPlan *plan, size_t end)
 {
-    size_t size = reflectGetObjSize(model);
-    if (obj == NULL)
-    {
-        obj = REFLECT_MALLOC(size);
-    }
-    REFLECT_ASSERT(obj, return NULL);
-    memcpy(obj, mem, size);
-
-    Reflection *p = model;
-    while (p->type != REFLECT_TYPE_OBJ)
+    for (size_t i = 0; i < plan->fieldCount; i++)
     {
+        ReflectPlanField *p = &plan->fields[i];
+        size_t field = (size_t)mem + p->offset;
+        size_t addr = *(size_t *)field + field;
         if (p->isPointer)
         {
-            *(size_t *)((size_t)obj + p->offset) = 
-                (size_t)cDeserialObj(
-                    (void *)(*(size_t *)((size_t)mem + p->offset) + ((size_t)mem + p->offset)),
-                    p->model,
-                    NULL);
+            if (*(size_t *)field != 0)
+            {
+                if (addr + p->plan->alignedSize > end)
+                {
+                    end = addr + p->plan->alignedSize;
+                }
+                end = cDeserialGetEnd((void *)addr, p->plan, end);
+            }
         }
         else if (p->type == REFLECT_TYPE_STRING)
-        {   
-            *(size_t *)((size_t)obj + p->offset) = 
-                (size_t)reflectNewString(
-                    (char *)((*(size_t *)((size_t)mem + p->offset)) + ((size_t)mem + p->offset)));
+        {
+            if (*(size_t *)field != 0
+                && addr + REFLECT_ALIGN(strlen((char *)addr) + 1) > end)
+            {
+                end = addr + REFLECT_ALIGN(strlen((char *)addr) + 1);
+            }
         }
         else if (p->type == REFLECT_TYPE_ARRAY)
         {
-            size_t itemSize = reflectGetObjSize(p->model);
-            for (size_t i = 0; i < p->size; i++)
+            for (size_t j = 0; j < p->count; j++)
             {
-                cDeserialObj(
-                   (void *)((size_t)mem + p->offset + itemSize * i),
-                   p->model,
-                   (void *)((size_t)obj + p->offset + itemSize * i));
+                end = cDeserialGetEnd((void *)(field + p->plan->size * j), p->plan, end);
             }
         }
         else if (p->type == REFLECT_TYPE_STRUCT)
         {
-            cDeserialObj(
-                (void *)((size_t)mem + p->offset),
-                p->model,
-                (void *)((size_t)obj + p->offset));
+            end = cDeserialGetEnd((void *)field, p->plan, end);
         }
         else if (p->type == REFLECT_TYPE_LIST)
         {
-            *(size_t *)((size_t)obj + p->offset) = 0;
-            if (*(size_t *)((size_t)mem + p->offset) != 0)
+            if (*(size_t *)field != 0)
             {
-                size_t index = 0;
-                ObjList *list;
+                ObjList *list = (ObjList *)addr;
                 do {
-                    list = (ObjList *)(*(size_t *)((size_t)mem + p->offset) 
-                        + ((size_t)mem + p->offset) + sizeof(ObjList) * index);
-                    void *item = cDeserialObj(
-                        (void *)((size_t)(&(list->obj)) + (size_t)list->obj),
-                        p->model,
-                        NULL);
-                    *(size_t *)((size_t)obj + p->offset) =
-                        (size_t)objListAdd((ObjList *)(*(size_t *)((size_t)obj + p->offset)), item);
-                    index++;
-                } while (list->next);
+                    size_t item = (size_t)(&(list->obj)) + (size_t)list->obj;
+                    if ((size_t)(list + 1) > end)
+                    {
+                        end = (size_t)(list + 1);
+                    }
+                    if (item + p->plan->alignedSize > end)
+                    {
+                        end = item + p->plan->alignedSize;
+                    }
+                    end = cDeserialGetEnd((void *)item, p->plan, end);
+                } while ((list++)->next);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            if (*(size_t *)field != 0)
+            {
+                size_t count = *(size_t *)((size_t)mem + p->countOffset);
+                if (addr + REFLECT_ALIGN(p->plan->size * count) > end)
+                {
+                    end = addr + REFLECT_ALIGN(p->plan->size * count);
+                }
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    end = cDeserialGetEnd((void *)(addr + p->plan->size * j), p->plan, end);
+                }
             }
         }
-        p++;
     }
-    return obj;
+    return end;
 }
 
 
 /**
- * @brief 反序列化
+ * @brief 反序列化到连续内存(arena)
+ *        对象的所有数据位于一块按序列化数据大小分配的连续内存中
  * 
  * @param mem 序列化数据地址
  * @param model Reflection 模型
  * @return void* 反序列化得到的对象
+ * @note 对象位于内存块起始处，使用 reflectFreeMem(obj) 一次释放所有数据，
+ *       不能使用 reflectFreeObj 释放，也不能修改对象的字符串，链表等字段
  */
-void *cDeserialize(void *mem, Reflection *model)
+void *cDeserializeArena(void *mem, Reflection *model)
+{
+    REFLECT_ASSERT(mem, return NULL);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_DESERIALIZE);
+    size_t size = cDeserialGetEnd(mem, plan, (size_t)mem + plan->alignedSize) - (size_t)mem;
+    void *obj = REFLECT_MALLOC(size);
+    if (obj)
+    {
+        memcpy(obj, mem, size);
+        cDeserialSwizzle(obj, plan);
+    }
+    REFLECT_STATS_END(scope, obj ? size : 0, 0);
+    return obj;
+}
+
+
+/**
+ * @brief 获取批量序列化数据中的对象数量
+ * 
+ * @param mem 批量序列化数据地址
+ * @return size_t 对象数量
+ */
+size_t cBatchGetCount(void *mem)
+{
+    REFLECT_ASSERT(mem, return 0);
+    return *(size_t *)mem;
+}
+
+
+/**
+ * @brief 获取批量序列化数据中的对象
+ *        通过偏移索引按序号访问，为O(1)操作
+ * 
+ * @param mem 批量序列化数据地址
+ * @param index 对象序号
+ * @return void* 对象的序列化数据，可用于 cDeserialize，cView 等接口，序号越界返回NULL
+ */
+void *cBatchGetItem(void *mem, size_t index)
+{
+    REFLECT_ASSERT(mem, return NULL);
+    if (index >= *(size_t *)mem)
+    {
+        return NULL;
+    }
+    return (void *)((size_t)mem + ((size_t *)mem)[index + 1]);
+}
+
+
+/**
+ * @brief 批量反序列化
+ *        所有对象反序列化到一个连续的对象数组中
+ * 
+ * @param mem 批量序列化数据地址
+ * @param model Reflection 模型
+ * @param count 对象数量，成功时写入，失败时为0，可为NULL
+ * @return void* 对象数组，对象数量为0或者内存不足时返回NULL
+ * @note 使用 cBatchFree 释放
+ */
+void *cDeserializeBatch(void *mem, Reflection *model, size_t *count)
 {
     REFLECT_ASSERT(mem, return NULL);
-    return cDeserialObj(mem, model, NULL);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    size_t size = *(size_t *)mem;
+    if (count)
+    {
+        *count = 0;
+    }
+    if (size == 0)
+    {
+        return NULL;
+    }
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_DESERIALIZE);
+    CDeserialContext ctx = {NULL, NULL, 0};
+    char *objs = REFLECT_MALLOC(plan->size * size);
+    size_t done = 0;
+    while (objs && done < size && !ctx.failed)
+    {
+        void *item = cBatchGetItem(mem, done);
+        memcpy(objs + plan->size * done, item, plan->size);
+        /* 失败的元素同样处理完所有字段，可以与之前的元素一起释放 */
+        cDeserialObj(item, plan, objs + plan->size * done++, &ctx);
+    }
+    if (ctx.failed)
+    {
+        cBatchFree(objs, done, model);
+        objs = NULL;
+    }
+    if (objs && count)
+    {
+        *count = size;
+    }
+    REFLECT_STATS_END(scope, 0, 0);
+    return objs;
+}
+
+
+/**
+ * @brief 释放批量反序列化得到的对象数组
+ * 
+ * @param objs 对象数组
+ * @param count 对象数量
+ * @param model Reflection 模型
+ */
+void cBatchFree(void *objs, size_t count, Reflection *model)
+{
+    REFLECT_ASSERT(objs, return);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_FREE);
+    for (size_t i = 0; i < count && !plan->isPlain; i++)
+    {
+        reflectFreePlanObj((void *)((size_t)objs + plan->size * i), plan, 0);
+    }
+    REFLECT_FREE(objs);
+    REFLECT_STATS_END(scope, 0, 0);
 }
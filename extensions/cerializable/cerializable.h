@@ -13,9 +13,49 @@
 #define __CERIALIZABLE_H__
 
 #include "reflection.h"
+#include "str_pool.h"
+#include "obj_map.h"
 
 #define CERIALIZABLE_VERSION        "1.0.0-beta1"
 
+#define CERIAL_STREAM_WINDOW        4096        /**< 流式序列化默认窗口大小 */
+
+#ifndef CERIAL_STREAM_SIZE_CACHE
+#define CERIAL_STREAM_SIZE_CACHE    1024        /**< 流式序列化最多记录的子数据大小数量，不小于1 */
+#endif
+
+#ifndef CERIAL_SNAPSHOT_ENABLE
+#if defined(__unix__) || defined(__APPLE__)
+#define CERIAL_SNAPSHOT_ENABLE      1           /**< 快照文件(mmap)支持，需要 POSIX 环境 */
+#else
+#define CERIAL_SNAPSHOT_ENABLE      0
+#endif
+#endif
+
+#define CERIAL_SNAPSHOT_MAGIC       "CRSN"      /**< 快照文件标识 */
+#define CERIAL_SNAPSHOT_VERSION     1           /**< 快照文件格式版本 */
+
+#ifndef CERIAL_PARALLEL_ENABLE
+#if defined(__unix__) || defined(__APPLE__)
+#define CERIAL_PARALLEL_ENABLE      1           /**< 并行序列化支持，需要 pthread */
+#else
+#define CERIAL_PARALLEL_ENABLE      0
+#endif
+#endif
+
+#define CERIAL_PARALLEL_MAX_THREADS 64          /**< 并行序列化最大线程数量 */
+
+#ifndef CERIAL_PARALLEL_MIN_ITEMS
+#define CERIAL_PARALLEL_MIN_ITEMS   1024        /**< 使用并行序列化的最少链表元素数量 */
+#endif
+
+#ifndef CERIAL_COMPACT_MAX_DEPTH
+#define CERIAL_COMPACT_MAX_DEPTH    256         /**< 紧凑格式反序列化最大嵌套深度 */
+#endif
+
+#define CERIAL_OPTION_SHARED        0x01        /**< 共享引用，被多处引用的对象只写入一次 */
+#define CERIAL_OPTION_STRING_TABLE  0x02        /**< 字符串表，相同内容的字符串只写入一次 */
+
 /**
  * @defgroup CERIALIZABLE cerializable
  * @brief c serializable
@@ -23,6 +63,101 @@
  * @{
  */
 
+/**
+ * @brief 序列化结果
+ * 
+ */
+typedef enum
+{
+    CERIAL_PENDING = 1,                         /**< 需要更多数据 */
+    CERIAL_OK = 0,                              /**< 成功 */
+    CERIAL_ERROR_NO_SPACE = -1,                 /**< 缓冲区空间不足 */
+    CERIAL_ERROR_NO_MEMORY = -2,                /**< 内存不足 */
+    CERIAL_ERROR_IO = -3,                       /**< 数据读写失败 */
+    CERIAL_ERROR_INVALID = -4,                  /**< 数据无效或与模型不匹配 */
+} CerialResult;
+
+/**
+ * @brief 可扩展的序列化缓冲区
+ * 
+ * @note 零初始化即为空缓冲区，缓冲区可以重复使用，重新使用前将 used 置 0
+ */
+typedef struct
+{
+    void *mem;                                  /**< 数据缓冲区 */
+    size_t size;                                /**< 缓冲区大小 */
+    size_t used;                                /**< 已使用的大小 */
+} CSerialBuffer;
+
+/**
+ * @brief 快照文件头
+ *        快照文件由文件头和 cSerialize 格式的序列化数据组成，文件头大小按 size_t 对齐
+ * 
+ */
+typedef struct
+{
+    char magic[4];                              /**< 文件标识 CERIAL_SNAPSHOT_MAGIC */
+    uint16_t version;                           /**< 文件格式版本 */
+    uint8_t pointerSize;                        /**< 指针(size_t)大小 */
+    uint8_t littleEndian;                       /**< 是否为小端字节序 */
+    uint64_t fingerprint;                       /**< 模型指纹 */
+    uint64_t size;                              /**< 序列化数据大小 */
+    uint32_t alignment;                         /**< 序列化数据对齐大小 */
+    uint32_t reserved;                          /**< 保留 */
+} CSnapshotHeader;
+
+/**
+ * @brief 快照
+ * 
+ */
+typedef struct
+{
+    void *map;                                  /**< 映射的文件内存 */
+    size_t mapSize;                             /**< 映射的文件大小 */
+    void *root;                                 /**< 根对象视图 */
+    size_t size;                                /**< 序列化数据大小 */
+} CSnapshot;
+
+/**
+ * @brief 序列化数据写函数
+ * 
+ * @param context 用户上下文
+ * @param data 数据
+ * @param size 数据大小
+ * @return int 0 成功 其他 失败
+ */
+typedef int (*CSerialWrite)(void *context, const void *data, size_t size);
+
+/**
+ * @brief 序列化数据读函数
+ * 
+ * @param context 用户上下文
+ * @param data 数据缓冲区
+ * @param size 最多读取的数据大小
+ * @return long 读取到的数据大小，0 表示数据结束，小于0 表示读取失败
+ */
+typedef long (*CSerialRead)(void *context, void *data, size_t size);
+
+/**
+ * @brief 流式反序列化器
+ *        数据分段输入，对象随数据到达逐步构建
+ * 
+ */
+typedef struct
+{
+    ReflectPlan *plan;                          /**< 执行计划 */
+    void *obj;                                  /**< 反序列化得到的对象 */
+    struct cerial_stream_task *tasks;           /**< 待处理任务栈 */
+    size_t taskCount;                           /**< 任务数量 */
+    size_t taskSize;                            /**< 任务栈大小 */
+    char *buffer;                               /**< 字符串缓冲区 */
+    size_t bufferSize;                          /**< 字符串缓冲区大小 */
+    size_t bufferUsed;                          /**< 字符串缓冲区已使用大小 */
+    size_t offset;                              /**< 已读取的数据大小 */
+    ObjMap strings;                             /**< 已读取的字符串，数据偏移 -> 字符串 */
+    int result;                                 /**< 反序列化结果 */
+} CDeserialStream;
+
 /**
  * @brief 序列化
  * 
@@ -33,15 +168,383 @@
  */
 void *cSerialize(void *obj, Reflection *model, size_t *size);
 
+/**
+ * @brief 并行序列化
+ *        元素数量不少于 CERIAL_PARALLEL_MIN_ITEMS 的链表使用多线程序列化，
+ *        得到的数据与 cSerialize 完全一致
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param size 序列化后的数据大小
+ * @param threads 线程数量，不大于1或者未使能 CERIAL_PARALLEL_ENABLE 时串行序列化
+ * @return void* 序列化得到的数据地址
+ * @note 序列化期间对象不能被修改
+ */
+void *cSerializeParallel(void *obj, Reflection *model, size_t *size, int threads);
+
+/**
+ * @brief 按选项序列化
+ *        CERIAL_OPTION_SHARED 被多处引用的子对象和链表对象只写入一次，对象之间可以存在循环引用，
+ *        CERIAL_OPTION_STRING_TABLE 相同内容的字符串只写入一次
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param size 序列化后的数据大小
+ * @param options 序列化选项，CERIAL_OPTION_SHARED，CERIAL_OPTION_STRING_TABLE 的组合
+ * @return void* 序列化得到的数据地址
+ * @note 数据可以直接使用 cView 系列接口访问，只使用 CERIAL_OPTION_STRING_TABLE 时，
+ *       数据可以使用 cDeserialize 和流式反序列化接口反序列化，
+ *       使用 CERIAL_OPTION_SHARED 时，反序列化需要使用 cDeserializeShared，
+ *       流式反序列化接口遇到共享引用时返回 CERIAL_ERROR_INVALID
+ */
+void *cSerializeEx(void *obj, Reflection *model, size_t *size, int options);
+
+/**
+ * @brief 共享引用序列化
+ *        被多处引用的子对象和链表对象只写入一次，对象之间可以存在循环引用
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param size 序列化后的数据大小
+ * @return void* 序列化得到的数据地址
+ * @note 数据格式与 cSerialize 相同，可以直接使用 cView 系列接口访问，
+ *       反序列化需要使用 cDeserializeShared
+ */
+void *cSerializeShared(void *obj, Reflection *model, size_t *size);
+
+/**
+ * @brief 序列化到指定的缓冲区
+ *        单次遍历对象，直接写入缓冲区，不分配内存
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buf 缓冲区，需要按 size_t 对齐
+ * @param cap 缓冲区大小
+ * @param used 序列化后的数据大小，缓冲区空间不足时为所需的缓冲区大小
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_SPACE 缓冲区空间不足
+ */
+int cSerializeInto(void *obj, Reflection *model, void *buf, size_t cap, size_t *used);
+
+/**
+ * @brief 序列化到可扩展的缓冲区
+ *        数据追加在 buffer->used 之后(按 size_t 对齐)，空间不足时自动扩展缓冲区
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeToBuffer(void *obj, Reflection *model, CSerialBuffer *buffer);
+
+/**
+ * @brief 批量序列化
+ *        所有对象写入同一块连续的数据，数据起始为对象数量和各对象的偏移索引，
+ *        执行计划和缓冲区在整批对象间复用，每个对象的数据与 cSerialize 格式一致
+ * 
+ * @param objs 对象数组
+ * @param count 对象数量
+ * @param model Reflection 模型
+ * @param buffer 缓冲区，数据追加在 buffer->used 之后(按 size_t 对齐)，空间不足时自动扩展
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ * @note 批量数据的起始地址为调用前 buffer->used 按 size_t 对齐后的位置
+ */
+int cSerializeBatch(void *objs, size_t count, Reflection *model, CSerialBuffer *buffer);
+
+/**
+ * @brief 释放可扩展缓冲区
+ * 
+ * @param buffer 缓冲区
+ */
+void cSerialBufferFree(CSerialBuffer *buffer);
+
+/**
+ * @brief 流式序列化
+ *        序列化数据经过固定大小的窗口缓冲，分段通过写函数输出，不需要完整的序列化数据内存，
+ *        除窗口外只占用最大对象的暂存区和最多 CERIAL_STREAM_SIZE_CACHE 条子数据大小记录
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param write 写函数
+ * @param context 写函数用户上下文
+ * @param window 窗口大小，为0时使用 CERIAL_STREAM_WINDOW
+ * @param size 序列化后的数据大小，可为NULL
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_IO 写函数失败 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeStream(void *obj, Reflection *model, CSerialWrite write, void *context,
+                     size_t window, size_t *size);
+
+/**
+ * @brief 初始化流式反序列化器
+ *        数据需要按 cSerialize 的顺序排列，字符串表中的字符串可以引用之前已读取的字符串，
+ *        其他指向已读取数据的引用(CERIAL_OPTION_SHARED)作为无效数据处理
+ * 
+ * @param stream 反序列化器
+ * @param model Reflection 模型
+ * @return int CERIAL_PENDING 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cDeserialStreamInit(CDeserialStream *stream, Reflection *model);
+
+/**
+ * @brief 流式反序列化输入数据
+ *        数据可以任意分段输入，每段数据处理完成后即可返回，等待下一段数据
+ * 
+ * @param stream 反序列化器
+ * @param data 数据
+ * @param size 数据大小
+ * @param consumed 使用的数据大小，对象完成后多余的数据不会被使用，可为NULL
+ * @return int CERIAL_PENDING 需要更多数据 CERIAL_OK 对象已完成 其他 错误
+ */
+int cDeserialStreamFeed(CDeserialStream *stream, const void *data, size_t size, size_t *consumed);
+
+/**
+ * @brief 获取流式反序列化器下一步可以使用的数据大小
+ *        按此大小读取数据不会读取到序列化数据之后的内容
+ * 
+ * @param stream 反序列化器
+ * @return size_t 数据大小，对象已完成或出错时为0
+ */
+size_t cDeserialStreamWant(CDeserialStream *stream);
+
+/**
+ * @brief 结束流式反序列化
+ * 
+ * @param stream 反序列化器
+ * @return void* 反序列化得到的对象，对象未完成时释放已构建的部分并返回NULL
+ */
+void *cDeserialStreamFinish(CDeserialStream *stream);
+
+/**
+ * @brief 从读函数流式反序列化
+ * 
+ * @param model Reflection 模型
+ * @param read 读函数
+ * @param context 读函数用户上下文
+ * @return void* 反序列化得到的对象，失败返回NULL
+ */
+void *cDeserializeStream(Reflection *model, CSerialRead read, void *context);
+
 /**
  * @brief 反序列化
  * 
  * @param mem 序列化数据地址
  * @param model Reflection 模型
- * @return void* 反序列化得到的对象
+ * @return void* 反序列化得到的对象，内存不足返回NULL
  */
 void *cDeserialize(void *mem, Reflection *model);
 
+/**
+ * @brief 按选项反序列化
+ *        CERIAL_OPTION_SHARED 将指向同一份数据的引用反序列化为同一个对象，
+ *        指定字符串池时，字符串驻留到字符串池中，相同内容的字符串只保存一份
+ * 
+ * @param mem 序列化数据地址
+ * @param model Reflection 模型
+ * @param options 反序列化选项，CERIAL_OPTION_SHARED
+ * @param pool 字符串池，为NULL时字符串单独分配
+ * @return void* 反序列化得到的对象
+ * @note 对象使用 reflectFreeObjOpt 释放，使用 CERIAL_OPTION_SHARED 时需要 REFLECT_FREE_SHARED 选项，
+ *       指定字符串池时需要 REFLECT_FREE_KEEP_STRINGS 选项，字符串在字符串池清空前有效且不能修改
+ */
+void *cDeserializeEx(void *mem, Reflection *model, int options, StrPool *pool);
+
+/**
+ * @brief 共享引用反序列化
+ *        指向同一份数据的引用反序列化为同一个对象，保留对象之间的共享和循环引用
+ * 
+ * @param mem 序列化数据地址
+ * @param model Reflection 模型
+ * @return void* 反序列化得到的对象
+ * @note 对象使用 reflectFreeShared 释放
+ */
+void *cDeserializeShared(void *mem, Reflection *model);
+
+/**
+ * @brief 原地反序列化
+ *        直接将序列化数据中的相对偏移转换为指针，不分配内存
+ * 
+ * @param mem 序列化数据地址
+ * @param model Reflection 模型
+ * @return void* 反序列化得到的对象，即 mem 本身
+ * @note 序列化数据被原地修改，只能原地反序列化一次，
+ *       对象的所有数据都位于 mem 中，使用 reflectFreeMem(mem) 释放，
+ *       不能使用 reflectFreeObj 释放，也不能修改对象的字符串，链表等字段
+ */
+void *cDeserializeInPlace(void *mem, Reflection *model);
+
+/**
+ * @brief 反序列化到连续内存(arena)
+ *        对象的所有数据位于一块按序列化数据大小分配的连续内存中
+ * 
+ * @param mem 序列化数据地址
+ * @param model Reflection 模型
+ * @return void* 反序列化得到的对象
+ * @note 对象位于内存块起始处，使用 reflectFreeMem(obj) 一次释放所有数据，
+ *       不能使用 reflectFreeObj 释放，也不能修改对象的字符串，链表等字段
+ */
+void *cDeserializeArena(void *mem, Reflection *model);
+
+/**
+ * @brief 获取批量序列化数据中的对象数量
+ * 
+ * @param mem 批量序列化数据地址
+ * @return size_t 对象数量
+ */
+size_t cBatchGetCount(void *mem);
+
+/**
+ * @brief 获取批量序列化数据中的对象
+ *        通过偏移索引按序号访问，为O(1)操作
+ * 
+ * @param mem 批量序列化数据地址
+ * @param index 对象序号
+ * @return void* 对象的序列化数据，可用于 cDeserialize，cView 等接口，序号越界返回NULL
+ */
+void *cBatchGetItem(void *mem, size_t index);
+
+/**
+ * @brief 批量反序列化
+ *        所有对象反序列化到一个连续的对象数组中
+ * 
+ * @param mem 批量序列化数据地址
+ * @param model Reflection 模型
+ * @param count 对象数量，成功时写入，失败时为0，可为NULL
+ * @return void* 对象数组，对象数量为0或者内存不足时返回NULL
+ * @note 使用 cBatchFree 释放
+ */
+void *cDeserializeBatch(void *mem, Reflection *model, size_t *count);
+
+/**
+ * @brief 释放批量反序列化得到的对象数组
+ * 
+ * @param objs 对象数组
+ * @param count 对象数量
+ * @param model Reflection 模型
+ */
+void cBatchFree(void *objs, size_t count, Reflection *model);
+
+/**
+ * @brief 紧凑格式序列化
+ *        整数使用变长编码，浮点数按小端存储，字符串带长度前缀，链表只记录元素数量，
+ *        不包含对齐填充和指针，数据与平台的字长和字节序无关
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区，数据追加在 buffer->used 之后，空间不足时自动扩展
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeCompact(void *obj, Reflection *model, CSerialBuffer *buffer);
+
+/**
+ * @brief 紧凑格式反序列化
+ * 
+ * @param mem 序列化数据地址
+ * @param size 序列化数据大小
+ * @param model Reflection 模型
+ * @param used 读取的数据大小，可为NULL
+ * @return void* 反序列化得到的对象，数据无效或内存不足返回NULL
+ * @note 数据读取均做越界检查，可以用于处理不可信的数据
+ */
+void *cDeserializeCompact(const void *mem, size_t size, Reflection *model, size_t *used);
+
+/**
+ * @brief 增量序列化
+ *        只写入新对象相对旧对象有变化的字段，链表写入元素的修改，插入和删除，
+ *        字段数据使用紧凑格式编码
+ * 
+ * @param oldObj 旧对象
+ * @param newObj 新对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区，数据追加在 buffer->used 之后，空间不足时自动扩展
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_NO_MEMORY 内存不足
+ */
+int cSerializeDelta(void *oldObj, void *newObj, Reflection *model, CSerialBuffer *buffer);
+
+/**
+ * @brief 应用增量
+ *        将 cSerializeDelta 得到的增量原地应用到对象上
+ * 
+ * @param obj 对象，需要与生成增量时的旧对象一致
+ * @param delta 增量数据
+ * @param size 增量数据大小
+ * @param model Reflection 模型
+ * @param used 读取的数据大小，可为NULL
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_INVALID 数据无效 CERIAL_ERROR_NO_MEMORY 内存不足
+ * @note 对象的字符串，子对象和链表需要使用 REFLECT_MALLOC 分配(与 reflectFreeObj 一致)，
+ *       返回错误时对象可能已被部分修改，但仍然可以使用 reflectFreeObj 释放
+ */
+int cApplyDelta(void *obj, const void *delta, size_t size, Reflection *model, size_t *used);
+
+/**
+ * @brief 获取序列化对象视图的字段
+ *        直接在序列化数据(未反序列化)上访问字段，不分配内存
+ * 
+ * @param view 序列化对象视图
+ * @param field 字段模型(模型数组中的元素)
+ * @return void* 字段数据地址，指针，字符串字段返回指向的数据(子对象视图，字符串)，
+ *               数组返回首元素，动态数组返回首元素(元素连续存储)，链表字段返回NULL(使用 cViewListItem 访问)
+ */
+void *cViewField(void *view, Reflection *field);
+
+/**
+ * @brief 获取序列化对象视图的数组元素
+ * 
+ * @param view 序列化对象视图
+ * @param field 数组字段模型
+ * @param index 元素序号
+ * @return void* 元素视图，序号越界返回NULL
+ */
+void *cViewArrayItem(void *view, Reflection *field, size_t index);
+
+/**
+ * @brief 获取序列化对象视图的链表大小
+ * 
+ * @param view 序列化对象视图
+ * @param field 链表字段模型
+ * @return size_t 链表大小
+ */
+size_t cViewListSize(void *view, Reflection *field);
+
+/**
+ * @brief 获取序列化对象视图的链表对象
+ *        序列化数据中链表节点连续存储，按序号访问为O(1)
+ * 
+ * @param view 序列化对象视图
+ * @param field 链表字段模型
+ * @param index 对象序号，需要小于 cViewListSize 得到的链表大小
+ * @return void* 对象视图
+ */
+void *cViewListItem(void *view, Reflection *field, size_t index);
+
+#if CERIAL_SNAPSHOT_ENABLE == 1
+/**
+ * @brief 保存快照文件
+ * 
+ * @param path 文件路径
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return int CERIAL_OK 成功 其他 错误
+ */
+int cSnapshotSave(const char *path, void *obj, Reflection *model);
+
+/**
+ * @brief 打开快照文件
+ *        文件以只读方式映射到内存，通过 snapshot->root 和 cView 系列接口直接访问，不进行反序列化
+ * 
+ * @param snapshot 快照
+ * @param path 文件路径
+ * @param model Reflection 模型
+ * @return int CERIAL_OK 成功 CERIAL_ERROR_INVALID 文件格式或模型不匹配 CERIAL_ERROR_IO 文件读取失败
+ */
+int cSnapshotOpen(CSnapshot *snapshot, const char *path, Reflection *model);
+
+/**
+ * @brief 关闭快照文件
+ * 
+ * @param snapshot 快照
+ */
+void cSnapshotClose(CSnapshot *snapshot);
+#endif
+
 /**
  * @}
  */
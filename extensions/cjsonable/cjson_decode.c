@@ -0,0 +1,1047 @@
+/**
+ * @file cjson_decode.c
+ * @author agent
+ * @brief c jsonable decoder
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "cjsonable.h"
+#include "cjson_internal.h"
+#include "string.h"
+#include "stdlib.h"
+#include "limits.h"
+#include "obj_list.h"
+
+
+#define CJSON_VECTOR_MIN_COUNT      8           /**< 动态数组初始容量 */
+
+/**
+ * @brief JSON 解码器
+ *
+ */
+typedef struct
+{
+    const char *pos;                            /**< 当前读取位置 */
+    const char *end;                            /**< 数据结束位置 */
+    int result;                                 /**< 解码结果 */
+} CJsonReader;
+
+
+/**
+ * @brief 标记数据无效
+ *
+ * @param reader 解码器
+ */
+static void cJsonFail(CJsonReader *reader)
+{
+    if (reader->result == CJSON_OK)
+    {
+        reader->result = CJSON_ERROR_INVALID;
+    }
+}
+
+
+/**
+ * @brief 跳过空白字符并获取下一个字符
+ *        下一个字符大于空格时直接返回，连续的空格(缩进)每次检查 8 字节
+ *
+ * @param reader 解码器
+ * @return int 下一个字符，数据结束或解码失败返回-1
+ */
+static int cJsonPeek(CJsonReader *reader)
+{
+    const char *p = reader->pos;
+    const char *end = reader->end;
+    while (p < end && (unsigned char)*p <= ' ')
+    {
+        if (end - p >= 8)
+        {
+            uint64_t word;
+            memcpy(&word, p, sizeof(word));
+            if (word == CJSON_WORD_ONES * ' ')
+            {
+                p += 8;
+                continue;
+            }
+        }
+        if (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+        {
+            break;
+        }
+        p++;
+    }
+    reader->pos = p;
+    return p < end && reader->result == CJSON_OK ? (unsigned char)*p : -1;
+}
+
+
+/**
+ * @brief 跳过空白字符后读取指定字符
+ *
+ * @param reader 解码器
+ * @param c 字符
+ * @return int 1 读取成功 0 下一个字符不是 c
+ */
+static int cJsonAccept(CJsonReader *reader, char c)
+{
+    if (cJsonPeek(reader) == (unsigned char)c)
+    {
+        reader->pos++;
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 读取字面量(true，false，null)
+ *
+ * @param reader 解码器
+ * @param literal 字面量
+ * @param len 字面量长度
+ * @return int 1 读取成功 0 不是该字面量
+ */
+static int cJsonAcceptLiteral(CJsonReader *reader, const char *literal, size_t len)
+{
+    if (cJsonPeek(reader) == (unsigned char)literal[0]
+        && (size_t)(reader->end - reader->pos) >= len
+        && memcmp(reader->pos, literal, len) == 0)
+    {
+        reader->pos += len;
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 扫描字符串
+ *        每次检查 8 字节，跳过不含'"'，'\\'和控制字符的部分
+ *
+ * @param reader 解码器，读取位置为开始的'"'之后
+ * @param escaped 字符串是否含有转义字符
+ * @return const char* 结束的'"'的地址，数据无效返回NULL
+ */
+static const char *cJsonScanString(CJsonReader *reader, char *escaped)
+{
+    const char *p = reader->pos;
+    const char *end = reader->end;
+    *escaped = 0;
+    while (1)
+    {
+        while (end - p >= 8)
+        {
+            uint64_t word;
+            memcpy(&word, p, sizeof(word));
+            if (CJSON_WORD_HAS_SPECIAL(word))
+            {
+                break;
+            }
+            p += 8;
+        }
+        if (p >= end)
+        {
+            break;
+        }
+        unsigned char c = *p;
+        if (c == '"')
+        {
+            return p;
+        }
+        else if (c == '\\')
+        {
+            if (end - p < 2)
+            {
+                break;
+            }
+            *escaped = 1;
+            p += 2;
+        }
+        else if (c < 0x20)
+        {
+            break;
+        }
+        else
+        {
+            p++;
+        }
+    }
+    cJsonFail(reader);
+    return NULL;
+}
+
+
+/**
+ * @brief 读取4位十六进制数
+ *
+ * @param p 数据
+ * @param end 数据结束位置
+ * @return long 数值，数据无效返回-1
+ */
+static long cJsonGetHex(const char *p, const char *end)
+{
+    long value = 0;
+    if (end - p < 4)
+    {
+        return -1;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        char c = p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+        {
+            value |= c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            value |= c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            value |= c - 'A' + 10;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    return value;
+}
+
+
+/**
+ * @brief 字符串反转义
+ *        \uXXXX 转换为 UTF-8，转换后的长度不超过原数据长度
+ *
+ * @param p 字符串数据(不含两端的'"')
+ * @param end 字符串数据结束位置
+ * @param dest 输出地址，大小不小于原数据长度
+ * @return long 转换后的长度，数据无效返回-1
+ */
+static long cJsonUnescape(const char *p, const char *end, char *dest)
+{
+    char *d = dest;
+    while (p < end)
+    {
+        if (*p != '\\')
+        {
+            *d++ = *p++;
+            continue;
+        }
+        p++;
+        switch (*p++)
+        {
+        case '"': *d++ = '"'; break;
+        case '\\': *d++ = '\\'; break;
+        case '/': *d++ = '/'; break;
+        case 'b': *d++ = '\b'; break;
+        case 'f': *d++ = '\f'; break;
+        case 'n': *d++ = '\n'; break;
+        case 'r': *d++ = '\r'; break;
+        case 't': *d++ = '\t'; break;
+        case 'u':
+        {
+            long code = cJsonGetHex(p, end);
+            if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF))
+            {
+                return -1;
+            }
+            p += 4;
+            if (code >= 0xD800 && code <= 0xDBFF)
+            {
+                /* 代理对 */
+                long low = end - p >= 6 && p[0] == '\\' && p[1] == 'u' ? cJsonGetHex(p + 2, end) : -1;
+                if (low < 0xDC00 || low > 0xDFFF)
+                {
+                    return -1;
+                }
+                p += 6;
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+            if (code < 0x80)
+            {
+                *d++ = (char)code;
+            }
+            else if (code < 0x800)
+            {
+                *d++ = (char)(0xC0 | (code >> 6));
+                *d++ = (char)(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                *d++ = (char)(0xE0 | (code >> 12));
+                *d++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                *d++ = (char)(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                *d++ = (char)(0xF0 | (code >> 18));
+                *d++ = (char)(0x80 | ((code >> 12) & 0x3F));
+                *d++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                *d++ = (char)(0x80 | (code & 0x3F));
+            }
+            break;
+        }
+        default:
+            return -1;
+        }
+    }
+    return d - dest;
+}
+
+
+/**
+ * @brief 读取字符串
+ *
+ * @param reader 解码器，下一个字符为'"'
+ * @return char* 字符串，失败返回NULL
+ */
+static char *cJsonGetString(CJsonReader *reader)
+{
+    char escaped;
+    reader->pos++;
+    const char *close = cJsonScanString(reader, &escaped);
+    REFLECT_ASSERT(close, return NULL);
+    size_t raw = close - reader->pos;
+    char *str = REFLECT_MALLOC(raw + 1);
+    if (!str)
+    {
+        reader->result = CJSON_ERROR_NO_MEMORY;
+        return NULL;
+    }
+    if (!escaped)
+    {
+        memcpy(str, reader->pos, raw);
+        str[raw] = '\0';
+    }
+    else
+    {
+        long len = cJsonUnescape(reader->pos, close, str);
+        if (len < 0)
+        {
+            REFLECT_FREE(str);
+            cJsonFail(reader);
+            return NULL;
+        }
+        str[len] = '\0';
+    }
+    reader->pos = close + 1;
+    return str;
+}
+
+
+/**
+ * @brief 读取对象的键并查找对应的字段
+ *
+ * @param reader 解码器
+ * @param plan 对象执行计划
+ * @return ReflectPlanField* 执行计划字段，模型中没有该字段或解码失败返回NULL
+ */
+static ReflectPlanField *cJsonGetKey(CJsonReader *reader, ReflectPlan *plan)
+{
+    Reflection *field = NULL;
+    char escaped;
+    if (cJsonPeek(reader) != '"')
+    {
+        cJsonFail(reader);
+        return NULL;
+    }
+    reader->pos++;
+    const char *close = cJsonScanString(reader, &escaped);
+    REFLECT_ASSERT(close, return NULL);
+    if (!escaped)
+    {
+        field = reflectPlanFindField(plan, reader->pos, close - reader->pos);
+    }
+    else
+    {
+        char *name = REFLECT_MALLOC(close - reader->pos + 1);
+        if (!name)
+        {
+            reader->result = CJSON_ERROR_NO_MEMORY;
+            return NULL;
+        }
+        long len = cJsonUnescape(reader->pos, close, name);
+        if (len < 0)
+        {
+            cJsonFail(reader);
+        }
+        else
+        {
+            field = reflectPlanFindField(plan, name, len);
+        }
+        REFLECT_FREE(name);
+    }
+    reader->pos = close + 1;
+    if (!cJsonAccept(reader, ':'))
+    {
+        cJsonFail(reader);
+        return NULL;
+    }
+    return field ? &plan->members[field - plan->model] : NULL;
+}
+
+
+/**
+ * @brief 扫描数值
+ *        按 JSON 数值语法检查
+ *
+ * @param reader 解码器
+ * @param isInteger 数值是否为整数(不含小数和指数部分)
+ * @return const char* 数值结束位置，数据无效返回NULL
+ */
+static const char *cJsonScanNumber(CJsonReader *reader, char *isInteger)
+{
+    const char *p = reader->pos;
+    const char *end = reader->end;
+    *isInteger = 1;
+    if (p < end && *p == '-')
+    {
+        p++;
+    }
+    if (p < end && *p == '0')
+    {
+        p++;
+    }
+    else if (p < end && *p >= '1' && *p <= '9')
+    {
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+    else
+    {
+        cJsonFail(reader);
+        return NULL;
+    }
+    if (p < end && *p == '.')
+    {
+        *isInteger = 0;
+        if (++p >= end || *p < '0' || *p > '9')
+        {
+            cJsonFail(reader);
+            return NULL;
+        }
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        *isInteger = 0;
+        p++;
+        if (p < end && (*p == '+' || *p == '-'))
+        {
+            p++;
+        }
+        if (p >= end || *p < '0' || *p > '9')
+        {
+            cJsonFail(reader);
+            return NULL;
+        }
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+    return p;
+}
+
+
+/**
+ * @brief 读取整数
+ *        true 和 false 分别读取为1和0
+ *
+ * @param reader 解码器
+ * @param min 最小值
+ * @param max 最大值
+ * @return int64_t 数值，失败时 reader->result 不为 CJSON_OK
+ */
+static int64_t cJsonGetInteger(CJsonReader *reader, int64_t min, int64_t max)
+{
+    if (cJsonAcceptLiteral(reader, "true", 4))
+    {
+        return 1;
+    }
+    else if (cJsonAcceptLiteral(reader, "false", 5))
+    {
+        return 0;
+    }
+
+    char isInteger;
+    const char *end = cJsonScanNumber(reader, &isInteger);
+    if (!end || !isInteger)
+    {
+        cJsonFail(reader);
+        return 0;
+    }
+    const char *p = reader->pos;
+    char negative = *p == '-';
+    uint64_t value = 0;
+    for (p += negative; p < end; p++)
+    {
+        unsigned int digit = *p - '0';
+        if (value > (UINT64_MAX - digit) / 10)
+        {
+            cJsonFail(reader);
+            return 0;
+        }
+        value = value * 10 + digit;
+    }
+    reader->pos = end;
+    if (value > (uint64_t)INT64_MAX + negative)
+    {
+        cJsonFail(reader);
+        return 0;
+    }
+    int64_t result = negative ? (int64_t)(0 - value) : (int64_t)value;
+    if (result < min || result > max)
+    {
+        cJsonFail(reader);
+        return 0;
+    }
+    return result;
+}
+
+
+/**
+ * @brief 读取浮点数
+ *        不超过15位有效数字的整数直接转换，其他数值使用 strtod 转换
+ *
+ * @param reader 解码器
+ * @return double 数值，失败时 reader->result 不为 CJSON_OK
+ */
+static double cJsonGetDouble(CJsonReader *reader)
+{
+    char isInteger;
+    const char *end = cJsonScanNumber(reader, &isInteger);
+    REFLECT_ASSERT(end, return 0);
+    const char *p = reader->pos;
+    size_t len = end - p;
+    double value;
+    if (isInteger && len - (*p == '-') <= 15)
+    {
+        int64_t integer = 0;
+        for (const char *c = p + (*p == '-'); c < end; c++)
+        {
+            integer = integer * 10 + (*c - '0');
+        }
+        value = *p == '-' ? -(double)integer : (double)integer;
+    }
+    else
+    {
+        char buf[CJSON_NUMBER_MAX_SIZE * 2];
+        char *text = len < sizeof(buf) ? buf : REFLECT_MALLOC(len + 1);
+        if (!text)
+        {
+            reader->result = CJSON_ERROR_NO_MEMORY;
+            return 0;
+        }
+        memcpy(text, p, len);
+        text[len] = '\0';
+        value = strtod(text, NULL);
+        if (text != buf)
+        {
+            REFLECT_FREE(text);
+        }
+    }
+    reader->pos = end;
+    return value;
+}
+
+
+/**
+ * @brief 跳过值
+ *        用于模型中没有的字段
+ *
+ * @param reader 解码器
+ * @param depth 嵌套深度
+ */
+static void cJsonSkipValue(CJsonReader *reader, size_t depth)
+{
+    char flag;
+    int c = cJsonPeek(reader);
+    if (depth > CJSON_MAX_DEPTH)
+    {
+        cJsonFail(reader);
+        return;
+    }
+    if (c == '"')
+    {
+        reader->pos++;
+        const char *close = cJsonScanString(reader, &flag);
+        reader->pos = close ? close + 1 : reader->pos;
+    }
+    else if (c == '{' || c == '[')
+    {
+        char close = c == '{' ? '}' : ']';
+        reader->pos++;
+        if (cJsonAccept(reader, close))
+        {
+            return;
+        }
+        do {
+            if (c == '{')
+            {
+                if (cJsonPeek(reader) != '"')
+                {
+                    cJsonFail(reader);
+                    return;
+                }
+                cJsonSkipValue(reader, depth + 1);
+                if (!cJsonAccept(reader, ':'))
+                {
+                    cJsonFail(reader);
+                    return;
+                }
+            }
+            cJsonSkipValue(reader, depth + 1);
+        } while (reader->result == CJSON_OK && cJsonAccept(reader, ','));
+        if (!cJsonAccept(reader, close))
+        {
+            cJsonFail(reader);
+        }
+    }
+    else if (c == '-' || (c >= '0' && c <= '9'))
+    {
+        const char *end = cJsonScanNumber(reader, &flag);
+        reader->pos = end ? end : reader->pos;
+    }
+    else if (!cJsonAcceptLiteral(reader, "true", 4)
+             && !cJsonAcceptLiteral(reader, "false", 5)
+             && !cJsonAcceptLiteral(reader, "null", 4))
+    {
+        cJsonFail(reader);
+    }
+}
+
+
+/**
+ * @brief 释放字段已有的数据
+ *        用于 JSON 对象中重复出现的键
+ *
+ * @param obj 对象
+ * @param p 执行计划字段
+ */
+static void cJsonClearField(void *obj, ReflectPlanField *p)
+{
+    void *addr = (void *)((size_t)obj + p->offset);
+    if (p->isPointer)
+    {
+        if (*(void **)addr)
+        {
+            reflectFreePlanObj(*(void **)addr, p->plan, 1);
+            *(void **)addr = NULL;
+        }
+        return;
+    }
+
+    switch (p->type)
+    {
+    case REFLECT_TYPE_STRING:
+        if (*(char **)addr)
+        {
+            REFLECT_FREE(*(char **)addr);
+            *(char **)addr = NULL;
+        }
+        break;
+    case REFLECT_TYPE_STRUCT:
+        reflectFreePlanObj(addr, p->plan, 0);
+        memset(addr, 0, p->plan->size);
+        break;
+    case REFLECT_TYPE_ARRAY:
+        for (size_t i = 0; i < p->count; i++)
+        {
+            reflectFreePlanObj((void *)((size_t)addr + p->plan->size * i), p->plan, 0);
+        }
+        memset(addr, 0, p->plan->size * p->count);
+        break;
+    case REFLECT_TYPE_LIST:
+    {
+        ObjList *list = *(ObjList **)addr;
+        while (list)
+        {
+            ObjList *next = list->next;
+            if (list->obj)
+            {
+                reflectFreePlanObj(list->obj, p->plan, 1);
+            }
+            objListNodeFree(list);
+            list = next;
+        }
+        *(ObjList **)addr = NULL;
+        break;
+    }
+    case REFLECT_TYPE_VECTOR:
+    {
+        char *items = *(char **)addr;
+        size_t *count = (size_t *)((size_t)obj + p->countOffset);
+        if (items)
+        {
+            for (size_t i = 0; i < *count; i++)
+            {
+                reflectFreePlanObj(items + p->plan->size * i, p->plan, 0);
+            }
+            REFLECT_FREE(items);
+            *(char **)addr = NULL;
+        }
+        *count = 0;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief 分配置0的对象
+ *
+ * @param reader 解码器
+ * @param size 对象大小
+ * @return void* 对象，内存不足返回NULL
+ */
+static void *cJsonNewObj(CJsonReader *reader, size_t size)
+{
+    void *obj = REFLECT_MALLOC(size);
+    if (!obj)
+    {
+        reader->result = CJSON_ERROR_NO_MEMORY;
+        return NULL;
+    }
+    memset(obj, 0, size);
+    return obj;
+}
+
+
+static void cJsonGetObj(CJsonReader *reader, void *obj, ReflectPlan *plan, size_t depth);
+
+/**
+ * @brief 读取字段值
+ *        分配的数据先写入对象再继续解码，解码失败时可以按模型释放
+ *
+ * @param reader 解码器
+ * @param obj 对象
+ * @param p 执行计划字段
+ * @param depth 嵌套深度
+ */
+static void cJsonGetField(CJsonReader *reader, void *obj, ReflectPlanField *p, size_t depth)
+{
+    void *addr = (void *)((size_t)obj + p->offset);
+    if (cJsonAcceptLiteral(reader, "null", 4))
+    {
+        return;
+    }
+
+    if (p->isPointer)
+    {
+        void *child = cJsonNewObj(reader, p->plan->size);
+        REFLECT_ASSERT(child, return);
+        *(void **)addr = child;
+        cJsonGetObj(reader, child, p->plan, depth + 1);
+        return;
+    }
+
+    switch (p->type)
+    {
+    case REFLECT_TYPE_CHAR:
+        *(char *)addr = (char)cJsonGetInteger(reader, CHAR_MIN, CHAR_MAX);
+        break;
+    case REFLECT_TYPE_SHORT:
+        *(short *)addr = (short)cJsonGetInteger(reader, SHRT_MIN, SHRT_MAX);
+        break;
+    case REFLECT_TYPE_INT:
+        *(int *)addr = (int)cJsonGetInteger(reader, INT_MIN, INT_MAX);
+        break;
+    case REFLECT_TYPE_LONG:
+        *(long *)addr = (long)cJsonGetInteger(reader, LONG_MIN, LONG_MAX);
+        break;
+    case REFLECT_TYPE_FLOAT:
+        *(float *)addr = (float)cJsonGetDouble(reader);
+        break;
+    case REFLECT_TYPE_DOUBLE:
+        *(double *)addr = cJsonGetDouble(reader);
+        break;
+    case REFLECT_TYPE_STRING:
+        if (cJsonPeek(reader) != '"')
+        {
+            cJsonFail(reader);
+            break;
+        }
+        *(char **)addr = cJsonGetString(reader);
+        break;
+    case REFLECT_TYPE_STRUCT:
+        cJsonGetObj(reader, addr, p->plan, depth + 1);
+        break;
+    case REFLECT_TYPE_ARRAY:
+    {
+        if (!cJsonAccept(reader, '['))
+        {
+            cJsonFail(reader);
+            break;
+        }
+        if (cJsonAccept(reader, ']'))
+        {
+            break;
+        }
+        size_t i = 0;
+        do {
+            if (i >= p->count)
+            {
+                cJsonFail(reader);
+                return;
+            }
+            cJsonGetObj(reader, (void *)((size_t)addr + p->plan->size * i++), p->plan, depth + 1);
+        } while (reader->result == CJSON_OK && cJsonAccept(reader, ','));
+        if (!cJsonAccept(reader, ']'))
+        {
+            cJsonFail(reader);
+        }
+        break;
+    }
+    case REFLECT_TYPE_LIST:
+    {
+        ObjListHead items = {0};
+        if (!cJsonAccept(reader, '['))
+        {
+            cJsonFail(reader);
+            break;
+        }
+        if (cJsonAccept(reader, ']'))
+        {
+            break;
+        }
+        do {
+            if (cJsonAcceptLiteral(reader, "null", 4))
+            {
+                /* null 元素解码为空元素，与编码一致 */
+                if (!objListHeadAdd(&items, NULL))
+                {
+                    reader->result = CJSON_ERROR_NO_MEMORY;
+                    return;
+                }
+                *(ObjList **)addr = items.head;
+                continue;
+            }
+            void *item = cJsonNewObj(reader, p->plan->size);
+            REFLECT_ASSERT(item, return);
+            if (!objListHeadAdd(&items, item))
+            {
+                REFLECT_FREE(item);
+                reader->result = CJSON_ERROR_NO_MEMORY;
+                return;
+            }
+            *(ObjList **)addr = items.head;
+            cJsonGetObj(reader, item, p->plan, depth + 1);
+        } while (reader->result == CJSON_OK && cJsonAccept(reader, ','));
+        if (!cJsonAccept(reader, ']'))
+        {
+            cJsonFail(reader);
+        }
+        break;
+    }
+    case REFLECT_TYPE_VECTOR:
+    {
+        size_t itemSize = p->plan->size;
+        size_t *count = (size_t *)((size_t)obj + p->countOffset);
+        size_t capacity = 0;
+        if (!cJsonAccept(reader, '['))
+        {
+            cJsonFail(reader);
+            break;
+        }
+        if (cJsonAccept(reader, ']'))
+        {
+            break;
+        }
+        do {
+            if (*count == capacity)
+            {
+                /* 元素按容量翻倍扩展，扩展后整体复制 */
+                size_t newCapacity = capacity ? capacity * 2 : CJSON_VECTOR_MIN_COUNT;
+                char *items = cJsonNewObj(reader, itemSize * newCapacity);
+                REFLECT_ASSERT(items, return);
+                if (*(char **)addr)
+                {
+                    memcpy(items, *(char **)addr, itemSize * *count);
+                    REFLECT_FREE(*(char **)addr);
+                }
+                *(char **)addr = items;
+                capacity = newCapacity;
+            }
+            cJsonGetObj(reader, *(char **)addr + itemSize * (*count)++, p->plan, depth + 1);
+        } while (reader->result == CJSON_OK && cJsonAccept(reader, ','));
+        if (!cJsonAccept(reader, ']'))
+        {
+            cJsonFail(reader);
+        }
+        break;
+    }
+    default:
+        cJsonFail(reader);
+        break;
+    }
+}
+
+
+/**
+ * @brief 读取对象
+ *        基础类型模型(字段没有名称)直接读取数值，其他模型读取 JSON 对象，
+ *        键通过执行计划的字段名索引查找，模型中没有的键跳过
+ *
+ * @param reader 解码器
+ * @param obj 对象，需要预先置0
+ * @param plan 执行计划，子对象使用执行计划字段中的子计划
+ * @param depth 嵌套深度
+ */
+static void cJsonGetObj(CJsonReader *reader, void *obj, ReflectPlan *plan, size_t depth)
+{
+    if (depth > CJSON_MAX_DEPTH)
+    {
+        cJsonFail(reader);
+        return;
+    }
+    REFLECT_STATS_DEPTH(depth + 1);
+    if (plan->memberCount && !plan->members[0].key)
+    {
+        cJsonGetField(reader, obj, &plan->members[0], depth);
+        return;
+    }
+
+    if (!cJsonAccept(reader, '{'))
+    {
+        cJsonFail(reader);
+        return;
+    }
+    if (cJsonAccept(reader, '}'))
+    {
+        return;
+    }
+    /* 记录已读取的字段，重复的键先释放之前读取的数据 */
+    uint64_t seen = 0;
+    do {
+        ReflectPlanField *field = cJsonGetKey(reader, plan);
+        if (reader->result != CJSON_OK)
+        {
+            return;
+        }
+        if (!field)
+        {
+            cJsonSkipValue(reader, depth + 1);
+            continue;
+        }
+        size_t index = field - plan->members;
+        if (index >= 64 || (seen & ((uint64_t)1 << index)))
+        {
+            cJsonClearField(obj, field);
+        }
+        seen |= index < 64 ? (uint64_t)1 << index : 0;
+        cJsonGetField(reader, obj, field, depth);
+    } while (reader->result == CJSON_OK && cJsonAccept(reader, ','));
+    if (!cJsonAccept(reader, '}'))
+    {
+        cJsonFail(reader);
+    }
+}
+
+
+/**
+ * @brief JSON 解码数据
+ *        解码失败时释放已经分配的数据，对象恢复为全0
+ *
+ * @param reader 解码器
+ * @param obj 对象，需要预先置0
+ * @param plan 执行计划
+ * @param used 读取的文本长度，为NULL时值之后只能有空白字符
+ * @return size_t 读取的文本长度，失败时为0，解码结果保存在 reader->result
+ */
+static size_t cJsonRead(CJsonReader *reader, void *obj, ReflectPlan *plan, size_t *used)
+{
+    const char *json = reader->pos;
+    cJsonGetObj(reader, obj, plan, 0);
+    const char *end = reader->pos;
+    if (cJsonPeek(reader) >= 0 && !used)
+    {
+        cJsonFail(reader);
+    }
+    if (reader->result != CJSON_OK)
+    {
+        reflectFreePlanObj(obj, plan, 0);
+        memset(obj, 0, plan->size);
+        return 0;
+    }
+    if (used)
+    {
+        *used = end - json;
+    }
+    return end - json;
+}
+
+
+/**
+ * @brief JSON 解码到对象
+ *
+ * @param json JSON 文本，不需要以'\0'结束
+ * @param size JSON 文本长度
+ * @param obj 对象，需要预先置0
+ * @param model Reflection 模型
+ * @param used 读取的文本长度，为NULL时值之后只能有空白字符
+ * @return int CJSON_OK 成功 CJSON_ERROR_NO_MEMORY 内存不足 CJSON_ERROR_INVALID 数据无效或与模型不匹配
+ * @note 解码失败时释放已经分配的数据，对象恢复为全0
+ */
+int cJsonDecodeInto(const char *json, size_t size, void *obj, Reflection *model, size_t *used)
+{
+    REFLECT_ASSERT(json, return CJSON_ERROR_INVALID);
+    REFLECT_ASSERT(obj, return CJSON_ERROR_INVALID);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CJSON_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_JSON_DECODE);
+    CJsonReader reader = {json, json + size, CJSON_OK};
+    size_t len = cJsonRead(&reader, obj, plan, used);
+    REFLECT_STATS_END(scope, len, 0);
+    (void)len;
+    return reader.result;
+}
+
+
+/**
+ * @brief JSON 解码
+ *
+ * @param json JSON 文本，不需要以'\0'结束
+ * @param size JSON 文本长度
+ * @param model Reflection 模型
+ * @param used 读取的文本长度，为NULL时值之后只能有空白字符
+ * @return void* 解码得到的对象，数据无效或内存不足返回NULL
+ * @note 对象使用 reflectFreeObj 释放
+ */
+void *cJsonDecode(const char *json, size_t size, Reflection *model, size_t *used)
+{
+    REFLECT_ASSERT(json, return NULL);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_JSON_DECODE);
+    size_t len = 0;
+    void *obj = REFLECT_MALLOC(plan->size);
+    if (obj)
+    {
+        CJsonReader reader = {json, json + size, CJSON_OK};
+        memset(obj, 0, plan->size);
+        len = cJsonRead(&reader, obj, plan, used);
+        if (reader.result != CJSON_OK)
+        {
+            REFLECT_FREE(obj);
+            obj = NULL;
+        }
+    }
+    REFLECT_STATS_END(scope, len, 0);
+    (void)len;
+    return obj;
+}
@@ -0,0 +1,882 @@
+/**
+ * @file cjson_encode.c
+ * @author agent
+ * @brief c jsonable encoder
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "cjsonable.h"
+#include "cjson_internal.h"
+#include "string.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "math.h"
+#include "obj_list.h"
+
+
+#define CJSON_BUFFER_MIN_SIZE       256
+
+
+/**
+ * @brief JSON 编码器
+ *
+ */
+typedef struct
+{
+    CJsonBuffer *buffer;                        /**< 输出缓冲区 */
+    int result;                                 /**< 编码结果 */
+} CJsonWriter;
+
+/**
+ * @brief 两位十进制数字表
+ *
+ */
+static const char cJsonDigits[200] =
+    "00010203040506070809" "10111213141516171819" "20212223242526272829"
+    "30313233343536373839" "40414243444546474849" "50515253545556575859"
+    "60616263646566676869" "70717273747576777879" "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * @brief 转义字符表，0 不需要转义，'u' 使用 \u00XX 转义，其他为转义后的字符
+ *
+ */
+static const char cJsonEscapes[256] =
+{
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+};
+
+
+/**
+ * @brief JSON 写入空间预留
+ *
+ * @param writer 编码器
+ * @param size 需要的空间大小(不含结束符)
+ * @return char* 写入地址，失败返回NULL
+ */
+static char *cJsonReserve(CJsonWriter *writer, size_t size)
+{
+    CJsonBuffer *buffer = writer->buffer;
+    if (writer->result != CJSON_OK)
+    {
+        return NULL;
+    }
+    /* 始终为结束符保留1字节 */
+    if (buffer->used + size + 1 > buffer->size)
+    {
+        size_t newSize = buffer->size ? buffer->size * 2 : CJSON_BUFFER_MIN_SIZE;
+        while (newSize < buffer->used + size + 1)
+        {
+            newSize *= 2;
+        }
+        char *mem = REFLECT_MALLOC(newSize);
+        if (!mem)
+        {
+            writer->result = CJSON_ERROR_NO_MEMORY;
+            return NULL;
+        }
+        if (buffer->mem)
+        {
+            memcpy(mem, buffer->mem, buffer->used);
+            REFLECT_FREE(buffer->mem);
+        }
+        buffer->mem = mem;
+        buffer->size = newSize;
+    }
+    return buffer->mem + buffer->used;
+}
+
+
+/**
+ * @brief JSON 写入数据
+ *
+ * @param writer 编码器
+ * @param data 数据
+ * @param size 数据大小
+ */
+static void cJsonPutData(CJsonWriter *writer, const char *data, size_t size)
+{
+    char *out = cJsonReserve(writer, size);
+    if (out)
+    {
+        memcpy(out, data, size);
+        writer->buffer->used += size;
+    }
+}
+
+
+/**
+ * @brief JSON 写入字符
+ *
+ * @param writer 编码器
+ * @param c 字符
+ */
+static void cJsonPutChar(CJsonWriter *writer, char c)
+{
+    char *out = cJsonReserve(writer, 1);
+    if (out)
+    {
+        *out = c;
+        writer->buffer->used++;
+    }
+}
+
+
+/**
+ * @brief 格式化无符号整数
+ *        从后向前每次转换两位数字
+ *
+ * @param out 输出地址，至少 CJSON_NUMBER_MAX_SIZE 字节
+ * @param value 数值
+ * @return size_t 文本长度
+ */
+static size_t cJsonFormatUnsigned(char *out, uint64_t value)
+{
+    char buf[CJSON_NUMBER_MAX_SIZE];
+    char *p = buf + sizeof(buf);
+    while (value >= 100)
+    {
+        unsigned int index = (unsigned int)(value % 100) * 2;
+        value /= 100;
+        *--p = cJsonDigits[index + 1];
+        *--p = cJsonDigits[index];
+    }
+    if (value >= 10)
+    {
+        *--p = cJsonDigits[value * 2 + 1];
+        *--p = cJsonDigits[value * 2];
+    }
+    else
+    {
+        *--p = (char)('0' + value);
+    }
+    size_t len = buf + sizeof(buf) - p;
+    memcpy(out, p, len);
+    return len;
+}
+
+
+/**
+ * @brief 格式化有符号整数
+ *
+ * @param out 输出地址，至少 CJSON_NUMBER_MAX_SIZE 字节
+ * @param value 数值
+ * @return size_t 文本长度
+ */
+static size_t cJsonFormatInteger(char *out, int64_t value)
+{
+    if (value < 0)
+    {
+        *out = '-';
+        return 1 + cJsonFormatUnsigned(out + 1, (uint64_t)0 - (uint64_t)value);
+    }
+    return cJsonFormatUnsigned(out, (uint64_t)value);
+}
+
+
+/**
+ * @brief 二进制浮点数 f * 2^e，f 为64位有效数字
+ *
+ */
+typedef struct
+{
+    uint64_t f;                                 /**< 有效数字 */
+    int e;                                      /**< 二进制指数 */
+} CJsonDiyFp;
+
+/**
+ * @brief 10的幂，10^k 约等于 f * 2^e
+ *
+ */
+typedef struct
+{
+    uint64_t f;                                 /**< 有效数字(最高位为1) */
+    short e;                                    /**< 二进制指数 */
+    short k;                                    /**< 十进制指数 */
+} CJsonCachedPower;
+
+/**
+ * @brief Grisu 使用的10的幂表，十进制指数从 -348 到 340，间隔 8
+ *
+ */
+static const CJsonCachedPower cJsonCachedPowers[] =
+{
+    {0xfa8fd5a0081c0288ULL, -1220, -348}, {0xbaaee17fa23ebf76ULL, -1193, -340}, {0x8b16fb203055ac76ULL, -1166, -332},
+    {0xcf42894a5dce35eaULL, -1140, -324}, {0x9a6bb0aa55653b2dULL, -1113, -316}, {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300}, {0xff77b1fcbebcdc4fULL, -1034, -292}, {0xbe5691ef416bd60cULL, -1007, -284},
+    {0x8dd01fad907ffc3cULL, -980, -276}, {0xd3515c2831559a83ULL, -954, -268}, {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252}, {0xaecc49914078536dULL, -874, -244}, {0x823c12795db6ce57ULL, -847, -236},
+    {0xc21094364dfb5637ULL, -821, -228}, {0x9096ea6f3848984fULL, -794, -220}, {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204}, {0xef340a98172aace5ULL, -715, -196}, {0xb23867fb2a35b28eULL, -688, -188},
+    {0x84c8d4dfd2c63f3bULL, -661, -180}, {0xc5dd44271ad3cdbaULL, -635, -172}, {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156}, {0xa3ab66580d5fdaf6ULL, -555, -148}, {0xf3e2f893dec3f126ULL, -529, -140},
+    {0xb5b5ada8aaff80b8ULL, -502, -132}, {0x87625f056c7c4a8bULL, -475, -124}, {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108}, {0xdff9772470297ebdULL, -396, -100}, {0xa6dfbd9fb8e5b88fULL, -369, -92},
+    {0xf8a95fcf88747d94ULL, -343, -84}, {0xb94470938fa89bcfULL, -316, -76}, {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60}, {0x993fe2c6d07b7facULL, -236, -52}, {0xe45c10c42a2b3b06ULL, -210, -44},
+    {0xaa242499697392d3ULL, -183, -36}, {0xfd87b5f28300ca0eULL, -157, -28}, {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12}, {0xd1b71758e219652cULL, -77, -4}, {0x9c40000000000000ULL, -50, 4},
+    {0xe8d4a51000000000ULL, -24, 12}, {0xad78ebc5ac620000ULL, 3, 20}, {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36}, {0x8f7e32ce7bea5c70ULL, 83, 44}, {0xd5d238a4abe98068ULL, 109, 52},
+    {0x9f4f2726179a2245ULL, 136, 60}, {0xed63a231d4c4fb27ULL, 162, 68}, {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84}, {0xc45d1df942711d9aULL, 242, 92}, {0x924d692ca61be758ULL, 269, 100},
+    {0xda01ee641a708deaULL, 295, 108}, {0xa26da3999aef774aULL, 322, 116}, {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132}, {0x865b86925b9bc5c2ULL, 402, 140}, {0xc83553c5c8965d3dULL, 428, 148},
+    {0x952ab45cfa97a0b3ULL, 455, 156}, {0xde469fbd99a05fe3ULL, 481, 164}, {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180}, {0xb7dcbf5354e9beceULL, 561, 188}, {0x88fcf317f22241e2ULL, 588, 196},
+    {0xcc20ce9bd35c78a5ULL, 614, 204}, {0x98165af37b2153dfULL, 641, 212}, {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228}, {0xfb9b7cd9a4a7443cULL, 720, 236}, {0xbb764c4ca7a44410ULL, 747, 244},
+    {0x8bab8eefb6409c1aULL, 774, 252}, {0xd01fef10a657842cULL, 800, 260}, {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276}, {0xac2820d9623bf429ULL, 880, 284}, {0x80444b5e7aa7cf85ULL, 907, 292},
+    {0xbf21e44003acdd2dULL, 933, 300}, {0x8e679c2f5e44ff8fULL, 960, 308}, {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324}, {0xeb96bf6ebadf77d9ULL, 1039, 332}, {0xaf87023b9bf0ee6bULL, 1066, 340}
+};
+
+
+/**
+ * @brief 64位有效数字相乘，结果保留高64位(四舍五入)
+ *
+ * @param a 乘数
+ * @param b 乘数
+ * @return CJsonDiyFp 乘积
+ */
+static CJsonDiyFp cJsonDiyFpMultiply(CJsonDiyFp a, CJsonDiyFp b)
+{
+    uint64_t ah = a.f >> 32, al = a.f & 0xFFFFFFFFu;
+    uint64_t bh = b.f >> 32, bl = b.f & 0xFFFFFFFFu;
+    uint64_t hl = ah * bl, lh = al * bh;
+    uint64_t mid = ((al * bl) >> 32) + (hl & 0xFFFFFFFFu) + (lh & 0xFFFFFFFFu) + (1u << 31);
+    CJsonDiyFp result = {ah * bh + (hl >> 32) + (lh >> 32) + (mid >> 32), a.e + b.e + 64};
+    return result;
+}
+
+
+/**
+ * @brief 规格化，使有效数字最高位为1
+ *
+ * @param v 数值，有效数字不为0
+ * @return CJsonDiyFp 规格化的数值
+ */
+static CJsonDiyFp cJsonDiyFpNormalize(CJsonDiyFp v)
+{
+    while (!(v.f & 0xFFC0000000000000ULL))
+    {
+        v.f <<= 10;
+        v.e -= 10;
+    }
+    while (!(v.f & 0x8000000000000000ULL))
+    {
+        v.f <<= 1;
+        v.e--;
+    }
+    return v;
+}
+
+
+/**
+ * @brief 修正最后一位数字，使结果最接近原数值，并检查结果是否可以确定为最短的精确表示
+ *
+ * @param digits 数字
+ * @param len 数字数量
+ * @param distance 上界到原数值的距离
+ * @param delta 不安全区间的宽度
+ * @param rest 当前数字到上界的距离
+ * @param tenKappa 最后一位数字的单位
+ * @param unit 误差单位
+ * @return int 1 结果可靠 0 无法确定，需要使用其他方法
+ */
+static int cJsonRoundWeed(char *digits, int len, uint64_t distance, uint64_t delta,
+                          uint64_t rest, uint64_t tenKappa, uint64_t unit)
+{
+    uint64_t smallDistance = distance - unit;
+    uint64_t bigDistance = distance + unit;
+    while (rest < smallDistance && delta - rest >= tenKappa
+           && (rest + tenKappa < smallDistance
+               || smallDistance - rest >= rest + tenKappa - smallDistance))
+    {
+        digits[len - 1]--;
+        rest += tenKappa;
+    }
+    if (rest < bigDistance && delta - rest >= tenKappa
+        && (rest + tenKappa < bigDistance
+            || bigDistance - rest > rest + tenKappa - bigDistance))
+    {
+        return 0;
+    }
+    return 2 * unit <= rest && rest <= delta - 4 * unit;
+}
+
+
+/**
+ * @brief 生成区间 (low, high) 内位数最少的十进制数字
+ *
+ * @param low 下界
+ * @param w 原数值
+ * @param high 上界
+ * @param digits 数字输出
+ * @param len 数字数量
+ * @param kappa 最后一位数字的十进制指数
+ * @return int 1 结果可靠 0 无法确定，需要使用其他方法
+ */
+static int cJsonDigitGen(CJsonDiyFp low, CJsonDiyFp w, CJsonDiyFp high,
+                         char *digits, int *len, int *kappa)
+{
+    /* 相乘的误差不超过1个单位，上下界各向外扩展1个单位 */
+    uint64_t unit = 1;
+    uint64_t tooLow = low.f - unit;
+    uint64_t tooHigh = high.f + unit;
+    uint64_t delta = tooHigh - tooLow;
+    int shift = -w.e;
+    uint64_t one = (uint64_t)1 << shift;
+    uint32_t integrals = (uint32_t)(tooHigh >> shift);
+    uint64_t fractionals = tooHigh & (one - 1);
+    uint32_t divisor = 1;
+    *kappa = 1;
+    while (divisor <= integrals / 10)
+    {
+        divisor *= 10;
+        (*kappa)++;
+    }
+    *len = 0;
+    while (*kappa > 0)
+    {
+        digits[(*len)++] = (char)('0' + integrals / divisor);
+        integrals %= divisor;
+        (*kappa)--;
+        uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+        if (rest < delta)
+        {
+            return cJsonRoundWeed(digits, *len, tooHigh - w.f, delta, rest,
+                                  (uint64_t)divisor << shift, unit);
+        }
+        divisor /= 10;
+    }
+    for (;;)
+    {
+        fractionals *= 10;
+        unit *= 10;
+        delta *= 10;
+        digits[(*len)++] = (char)('0' + (fractionals >> shift));
+        fractionals &= one - 1;
+        (*kappa)--;
+        if (fractionals < delta)
+        {
+            return cJsonRoundWeed(digits, *len, (tooHigh - w.f) * unit, delta,
+                                  fractionals, one, unit);
+        }
+    }
+}
+
+
+/**
+ * @brief Grisu3 生成能够精确还原数值的最短十进制数字
+ *        单精度浮点数按单精度的舍入区间计算，约0.5%的数值无法确定结果，需要使用其他方法
+ *
+ * @param value 数值，有限的正数
+ * @param isFloat 是否为单精度浮点数
+ * @param digits 数字输出，至少18字节
+ * @param len 数字数量
+ * @param exponent 十进制指数，数值等于 digits * 10^exponent
+ * @return int 1 成功 0 无法确定
+ */
+static int cJsonGrisu3(double value, char isFloat, char *digits, int *len, int *exponent)
+{
+    CJsonDiyFp v, high, low;
+    int lowerCloser;
+    if (isFloat)
+    {
+        float single = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &single, sizeof(bits));
+        uint32_t biased = bits >> 23 & 0xFF;
+        v.f = bits & 0x7FFFFF;
+        v.e = biased ? (int)biased - 150 : -149;
+        v.f |= biased ? 0x800000 : 0;
+        lowerCloser = (bits & 0x7FFFFF) == 0 && biased > 1;
+    }
+    else
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint64_t biased = bits >> 52 & 0x7FF;
+        v.f = bits & 0xFFFFFFFFFFFFFULL;
+        v.e = biased ? (int)biased - 1075 : -1074;
+        v.f |= biased ? 0x10000000000000ULL : 0;
+        lowerCloser = (bits & 0xFFFFFFFFFFFFFULL) == 0 && biased > 1;
+    }
+    /* 舍入区间为相邻两个可表示数值的中点之间 */
+    high.f = (v.f << 1) + 1;
+    high.e = v.e - 1;
+    high = cJsonDiyFpNormalize(high);
+    low.f = lowerCloser ? (v.f << 2) - 1 : (v.f << 1) - 1;
+    low.e = lowerCloser ? v.e - 2 : v.e - 1;
+    low.f <<= low.e - high.e;
+    low.e = high.e;
+    v = cJsonDiyFpNormalize(v);
+
+    /* 选择 10^-k 使乘积的二进制指数位于 [-60, -32]，整数部分不超过32位 */
+    int k = (int)ceil((-60 - (v.e + 64) + 63) * 0.30102999566398114);
+    const CJsonCachedPower *power = &cJsonCachedPowers[(348 + k - 1) / 8 + 1];
+    CJsonDiyFp c = {power->f, power->e};
+    int kappa;
+    int result = cJsonDigitGen(cJsonDiyFpMultiply(low, c), cJsonDiyFpMultiply(v, c),
+                               cJsonDiyFpMultiply(high, c), digits, len, &kappa);
+    *exponent = kappa - power->k;
+    return result;
+}
+
+
+/**
+ * @brief 按 %g 的格式输出十进制数字
+ *        首位数字的指数小于-4或不小于 precision 时使用科学计数法
+ *
+ * @param out 输出地址
+ * @param digits 数字
+ * @param len 数字数量
+ * @param exponent 首位数字的十进制指数
+ * @param precision 精度
+ * @return size_t 文本长度
+ */
+static size_t cJsonFormatDigits(char *out, const char *digits, int len, int exponent, int precision)
+{
+    char *p = out;
+    if (exponent < -4 || exponent >= precision)
+    {
+        *p++ = digits[0];
+        if (len > 1)
+        {
+            *p++ = '.';
+            memcpy(p, digits + 1, len - 1);
+            p += len - 1;
+        }
+        *p++ = 'e';
+        *p++ = exponent < 0 ? '-' : '+';
+        exponent = exponent < 0 ? -exponent : exponent;
+        if (exponent >= 100)
+        {
+            *p++ = (char)('0' + exponent / 100);
+            exponent %= 100;
+        }
+        *p++ = cJsonDigits[exponent * 2];
+        *p++ = cJsonDigits[exponent * 2 + 1];
+    }
+    else if (exponent < 0)
+    {
+        memcpy(p, "0.0000", 1 - exponent);
+        p += 1 - exponent;
+        memcpy(p, digits, len);
+        p += len;
+    }
+    else if (len > exponent + 1)
+    {
+        memcpy(p, digits, exponent + 1);
+        p += exponent + 1;
+        *p++ = '.';
+        memcpy(p, digits + exponent + 1, len - exponent - 1);
+        p += len - exponent - 1;
+    }
+    else
+    {
+        memcpy(p, digits, len);
+        memset(p + len, '0', exponent + 1 - len);
+        p += exponent + 1;
+    }
+    return p - out;
+}
+
+
+/**
+ * @brief 格式化浮点数
+ *        整数值直接按整数格式化，其他数值使用 Grisu3 得到能够精确还原数值的最短数字，
+ *        Grisu3 无法确定结果时(约0.5%)从 %.15g (单精度 %.6g) 起逐位增加精度，
+ *        输出与区域设置无关，非有限数值写入 null
+ *
+ * @param out 输出地址，至少 CJSON_NUMBER_MAX_SIZE 字节
+ * @param value 数值
+ * @param isFloat 是否为单精度浮点数
+ * @return size_t 文本长度
+ */
+static size_t cJsonFormatDouble(char *out, double value, char isFloat)
+{
+    if (!isfinite(value))
+    {
+        memcpy(out, "null", 4);
+        return 4;
+    }
+    if (value == 0 && signbit(value))
+    {
+        memcpy(out, "-0.0", 4);
+        return 4;
+    }
+    if (value > -1e15 && value < 1e15 && value == (double)(int64_t)value)
+    {
+        return cJsonFormatInteger(out, (int64_t)value);
+    }
+
+    char *p = out;
+    if (value < 0)
+    {
+        *p++ = '-';
+        value = -value;
+    }
+    char digits[24];
+    int len;
+    int exponent;
+    if (cJsonGrisu3(value, isFloat, digits, &len, &exponent))
+    {
+        /* 与 %.15g (单精度 %.6g) 起逐位增加精度得到的格式一致 */
+        int precision = isFloat ? 6 : 15;
+        return (p - out) + cJsonFormatDigits(p, digits, len, exponent + len - 1,
+                                             len > precision ? len : precision);
+    }
+
+    /* 单精度最多需要9位有效数字，双精度最多需要17位，snprintf 和 strtod 使用相同的区域设置 */
+    int precision = isFloat ? 6 : 15;
+    int maxPrecision = isFloat ? 9 : 17;
+    int size;
+    for (;; precision++)
+    {
+        size = snprintf(p, CJSON_NUMBER_MAX_SIZE - 1, "%.*g", precision, value);
+        if (precision >= maxPrecision
+            || (isFloat ? strtof(p, NULL) == (float)value : strtod(p, NULL) == value))
+        {
+            break;
+        }
+    }
+    for (int i = 0; i < size; i++)
+    {
+        /* 区域设置的小数点可能不是 '.' */
+        if ((p[i] < '0' || p[i] > '9') && p[i] != 'e' && p[i] != '-' && p[i] != '+')
+        {
+            p[i] = '.';
+        }
+    }
+    return (p - out) + size;
+}
+
+
+/**
+ * @brief JSON 写入整数
+ *
+ * @param writer 编码器
+ * @param value 数值
+ */
+static void cJsonPutInteger(CJsonWriter *writer, int64_t value)
+{
+    char *out = cJsonReserve(writer, CJSON_NUMBER_MAX_SIZE);
+    if (out)
+    {
+        writer->buffer->used += cJsonFormatInteger(out, value);
+    }
+}
+
+
+/**
+ * @brief JSON 写入浮点数
+ *
+ * @param writer 编码器
+ * @param value 数值
+ * @param isFloat 是否为单精度浮点数
+ */
+static void cJsonPutDouble(CJsonWriter *writer, double value, char isFloat)
+{
+    char *out = cJsonReserve(writer, CJSON_NUMBER_MAX_SIZE);
+    if (out)
+    {
+        writer->buffer->used += cJsonFormatDouble(out, value, isFloat);
+    }
+}
+
+
+/**
+ * @brief JSON 写入字符串
+ *        每次检查 8 字节，不含需要转义字符的部分整段复制
+ *
+ * @param writer 编码器
+ * @param str 字符串
+ */
+static void cJsonPutString(CJsonWriter *writer, const char *str)
+{
+    size_t len = strlen(str);
+    const char *p = str;
+    const char *end = str + len;
+    const char *run = str;
+
+    cJsonPutChar(writer, '"');
+    while (p < end)
+    {
+        if (end - p >= 8)
+        {
+            uint64_t word;
+            memcpy(&word, p, sizeof(word));
+            if (!CJSON_WORD_HAS_SPECIAL(word))
+            {
+                p += 8;
+                continue;
+            }
+        }
+
+        char escape = cJsonEscapes[(unsigned char)*p];
+        if (escape)
+        {
+            cJsonPutData(writer, run, p - run);
+            char *out = cJsonReserve(writer, 6);
+            if (!out)
+            {
+                return;
+            }
+            out[0] = '\\';
+            out[1] = escape;
+            if (escape == 'u')
+            {
+                out[2] = '0';
+                out[3] = '0';
+                out[4] = "0123456789abcdef"[(unsigned char)*p >> 4];
+                out[5] = "0123456789abcdef"[(unsigned char)*p & 0xF];
+                writer->buffer->used += 6;
+            }
+            else
+            {
+                writer->buffer->used += 2;
+            }
+            run = p + 1;
+        }
+        p++;
+    }
+    cJsonPutData(writer, run, end - run);
+    cJsonPutChar(writer, '"');
+}
+
+
+static void cJsonPutObj(CJsonWriter *writer, void *obj, ReflectPlan *plan, size_t depth);
+
+/**
+ * @brief JSON 写入字段值
+ *
+ * @param writer 编码器
+ * @param obj 字段所在的对象
+ * @param p 执行计划字段
+ * @param depth 嵌套深度
+ */
+static void cJsonPutField(CJsonWriter *writer, void *obj, ReflectPlanField *p, size_t depth)
+{
+    void *addr = (void *)((size_t)obj + p->offset);
+    if (p->isPointer)
+    {
+        void *child = *(void **)addr;
+        if (child)
+        {
+            cJsonPutObj(writer, child, p->plan, depth + 1);
+        }
+        else
+        {
+            cJsonPutData(writer, "null", 4);
+        }
+        return;
+    }
+
+    switch (p->type)
+    {
+    case REFLECT_TYPE_CHAR:
+        cJsonPutInteger(writer, *(char *)addr);
+        break;
+    case REFLECT_TYPE_SHORT:
+        cJsonPutInteger(writer, *(short *)addr);
+        break;
+    case REFLECT_TYPE_INT:
+        cJsonPutInteger(writer, *(int *)addr);
+        break;
+    case REFLECT_TYPE_LONG:
+        cJsonPutInteger(writer, *(long *)addr);
+        break;
+    case REFLECT_TYPE_FLOAT:
+        cJsonPutDouble(writer, *(float *)addr, 1);
+        break;
+    case REFLECT_TYPE_DOUBLE:
+        cJsonPutDouble(writer, *(double *)addr, 0);
+        break;
+    case REFLECT_TYPE_STRING:
+        if (*(char **)addr)
+        {
+            cJsonPutString(writer, *(char **)addr);
+        }
+        else
+        {
+            cJsonPutData(writer, "null", 4);
+        }
+        break;
+    case REFLECT_TYPE_STRUCT:
+        cJsonPutObj(writer, addr, p->plan, depth + 1);
+        break;
+    case REFLECT_TYPE_ARRAY:
+        cJsonPutChar(writer, '[');
+        for (size_t i = 0; i < p->count; i++)
+        {
+            if (i != 0)
+            {
+                cJsonPutChar(writer, ',');
+            }
+            cJsonPutObj(writer, (void *)((size_t)addr + p->plan->size * i), p->plan, depth + 1);
+        }
+        cJsonPutChar(writer, ']');
+        break;
+    case REFLECT_TYPE_LIST:
+    {
+        ObjList *list = *(ObjList **)addr;
+        cJsonPutChar(writer, '[');
+        while (list)
+        {
+            if (list->obj)
+            {
+                cJsonPutObj(writer, list->obj, p->plan, depth + 1);
+            }
+            else
+            {
+                /* 链表中的空元素与紧凑格式一致保留为 null */
+                cJsonPutData(writer, "null", 4);
+            }
+            list = list->next;
+            if (list)
+            {
+                cJsonPutChar(writer, ',');
+            }
+        }
+        cJsonPutChar(writer, ']');
+        break;
+    }
+    case REFLECT_TYPE_VECTOR:
+    {
+        char *items = *(char **)addr;
+        size_t count = items ? *(size_t *)((size_t)obj + p->countOffset) : 0;
+        cJsonPutChar(writer, '[');
+        for (size_t i = 0; i < count; i++)
+        {
+            if (i != 0)
+            {
+                cJsonPutChar(writer, ',');
+            }
+            cJsonPutObj(writer, items + p->plan->size * i, p->plan, depth + 1);
+        }
+        cJsonPutChar(writer, ']');
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief JSON 写入对象
+ *        基础类型模型(字段没有名称)直接写入数值，其他模型写入 JSON 对象，
+ *        字段名使用执行计划中预先生成的键文本
+ *
+ * @param writer 编码器
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param depth 嵌套深度
+ */
+static void cJsonPutObj(CJsonWriter *writer, void *obj, ReflectPlan *plan, size_t depth)
+{
+    if (depth > CJSON_MAX_DEPTH)
+    {
+        writer->result = CJSON_ERROR_INVALID;
+        return;
+    }
+    REFLECT_STATS_DEPTH(depth + 1);
+    if (plan->memberCount && !plan->members[0].key)
+    {
+        cJsonPutField(writer, obj, &plan->members[0], depth);
+        return;
+    }
+
+    cJsonPutChar(writer, '{');
+    for (size_t i = 0; i < plan->memberCount; i++)
+    {
+        ReflectPlanField *p = &plan->members[i];
+        cJsonPutData(writer, p->key + (i == 0), p->keyLen - (i == 0));
+        cJsonPutField(writer, obj, p, depth);
+    }
+    cJsonPutChar(writer, '}');
+}
+
+
+/**
+ * @brief JSON 编码
+ *        数据追加在 buffer->used 之后，空间不足时自动扩展缓冲区
+ *
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区
+ * @return int CJSON_OK 成功 CJSON_ERROR_NO_MEMORY 内存不足 CJSON_ERROR_INVALID 嵌套深度超过 CJSON_MAX_DEPTH
+ */
+int cJsonEncode(void *obj, Reflection *model, CJsonBuffer *buffer)
+{
+    REFLECT_ASSERT(obj, return CJSON_ERROR_INVALID);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return CJSON_ERROR_NO_MEMORY);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_JSON_ENCODE);
+    size_t used = buffer->used;
+    CJsonWriter writer = {buffer, CJSON_OK};
+    cJsonPutObj(&writer, obj, plan, 0);
+    if (writer.result != CJSON_OK)
+    {
+        buffer->used = used;
+    }
+    if (buffer->mem)
+    {
+        buffer->mem[buffer->used] = '\0';
+    }
+    REFLECT_STATS_END(scope, 0, buffer->used - used);
+    return writer.result;
+}
+
+
+/**
+ * @brief JSON 编码为字符串
+ *
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param len 字符串长度，可为NULL
+ * @return char* JSON 字符串，使用 REFLECT_FREE 释放，失败返回NULL
+ */
+char *cJsonStringify(void *obj, Reflection *model, size_t *len)
+{
+    CJsonBuffer buffer = {0};
+    if (cJsonEncode(obj, model, &buffer) != CJSON_OK)
+    {
+        cJsonBufferFree(&buffer);
+        return NULL;
+    }
+    if (len)
+    {
+        *len = buffer.used;
+    }
+    return buffer.mem;
+}
+
+
+/**
+ * @brief 释放 JSON 文本缓冲区
+ *
+ * @param buffer 缓冲区
+ */
+void cJsonBufferFree(CJsonBuffer *buffer)
+{
+    if (buffer->mem)
+    {
+        REFLECT_FREE(buffer->mem);
+    }
+    buffer->mem = NULL;
+    buffer->size = 0;
+    buffer->used = 0;
+}
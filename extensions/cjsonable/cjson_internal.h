@@ -0,0 +1,43 @@
+/**
+ * @file cjson_internal.h
+ * @author agent
+ * @brief c jsonable internal
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright (c) 2026 agent
+ * 
+ */
+
+#ifndef __CJSON_INTERNAL_H__
+#define __CJSON_INTERNAL_H__
+
+#include "reflection.h"
+#include "cjsonable.h"
+
+#define CJSON_NUMBER_MAX_SIZE       32          /**< 数值文本的最大长度 */
+
+#define CJSON_WORD_ONES             0x0101010101010101ULL
+#define CJSON_WORD_HIGHS            0x8080808080808080ULL
+
+/**
+ * @brief 判断 8 字节中是否有字节为0
+ *        没有漏判，可能误判，误判时由逐字节处理修正
+ *
+ * @param word 数据
+ */
+#define CJSON_WORD_HAS_ZERO(word) \
+        (((word) - CJSON_WORD_ONES) & ~(word) & CJSON_WORD_HIGHS)
+
+/**
+ * @brief 判断 8 字节中是否有字符串中需要特殊处理的字符(控制字符，'"'，'\\')
+ *        没有漏判，可能误判
+ *
+ * @param word 数据
+ */
+#define CJSON_WORD_HAS_SPECIAL(word) \
+        ((((word) - CJSON_WORD_ONES * 0x20) & ~(word) & CJSON_WORD_HIGHS) \
+         | CJSON_WORD_HAS_ZERO((word) ^ (CJSON_WORD_ONES * '"')) \
+         | CJSON_WORD_HAS_ZERO((word) ^ (CJSON_WORD_ONES * '\\')))
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file cjsonable.h
+ * @author agent
+ * @brief c jsonable
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright (c) 2026 agent
+ * 
+ */
+
+#ifndef __CJSONABLE_H__
+#define __CJSONABLE_H__
+
+#include "reflection.h"
+
+#define CJSONABLE_VERSION           "1.0.0-beta1"
+
+#ifndef CJSON_MAX_DEPTH
+#define CJSON_MAX_DEPTH             256         /**< JSON 最大嵌套深度 */
+#endif
+
+/**
+ * @defgroup CJSONABLE cjsonable
+ * @brief c jsonable
+ * @addtogroup CJSONABLE
+ * @{
+ */
+
+/**
+ * @brief JSON 编解码结果
+ * 
+ */
+typedef enum
+{
+    CJSON_OK = 0,                               /**< 成功 */
+    CJSON_ERROR_NO_MEMORY = -2,                 /**< 内存不足 */
+    CJSON_ERROR_INVALID = -4,                   /**< 数据无效或与模型不匹配 */
+} CJsonResult;
+
+/**
+ * @brief 可扩展的 JSON 文本缓冲区
+ * 
+ * @note 零初始化即为空缓冲区，缓冲区可以重复使用，重新使用前将 used 置 0，
+ *       编码成功后 mem[used] 为'\0'
+ */
+typedef struct
+{
+    char *mem;                                  /**< 数据缓冲区 */
+    size_t size;                                /**< 缓冲区大小 */
+    size_t used;                                /**< 已使用的大小(不含结束符) */
+} CJsonBuffer;
+
+/**
+ * @brief JSON 编码
+ *        数据追加在 buffer->used 之后，空间不足时自动扩展缓冲区
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param buffer 缓冲区
+ * @return int CJSON_OK 成功 CJSON_ERROR_NO_MEMORY 内存不足 CJSON_ERROR_INVALID 嵌套深度超过 CJSON_MAX_DEPTH
+ */
+int cJsonEncode(void *obj, Reflection *model, CJsonBuffer *buffer);
+
+/**
+ * @brief JSON 编码为字符串
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param len 字符串长度，可为NULL
+ * @return char* JSON 字符串，使用 REFLECT_FREE 释放，失败返回NULL
+ */
+char *cJsonStringify(void *obj, Reflection *model, size_t *len);
+
+/**
+ * @brief 释放 JSON 文本缓冲区
+ * 
+ * @param buffer 缓冲区
+ */
+void cJsonBufferFree(CJsonBuffer *buffer);
+
+/**
+ * @brief JSON 解码到对象
+ *        直接按模型解码，不建立中间的 JSON 树，模型中没有的键跳过，
+ *        值为 null 的字段保持为0
+ *
+ * @param json JSON 文本，不需要以'\0'结束
+ * @param size JSON 文本长度
+ * @param obj 对象，需要预先置0
+ * @param model Reflection 模型
+ * @param used 读取的文本长度，为NULL时值之后只能有空白字符
+ * @return int CJSON_OK 成功 CJSON_ERROR_NO_MEMORY 内存不足 CJSON_ERROR_INVALID 数据无效或与模型不匹配
+ * @note 对象中分配的数据使用 reflectFreeObjEx(obj, model, 0) 释放，
+ *       解码失败时释放已经分配的数据，对象恢复为全0
+ */
+int cJsonDecodeInto(const char *json, size_t size, void *obj, Reflection *model, size_t *used);
+
+/**
+ * @brief JSON 解码
+ *
+ * @param json JSON 文本，不需要以'\0'结束
+ * @param size JSON 文本长度
+ * @param model Reflection 模型
+ * @param used 读取的文本长度，为NULL时值之后只能有空白字符
+ * @return void* 解码得到的对象，使用 reflectFreeObj 释放，失败返回NULL
+ */
+void *cJsonDecode(const char *json, size_t size, Reflection *model, size_t *used);
+
+/**
+ * @}
+ */
+
+#endif
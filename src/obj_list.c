@@ -11,13 +11,194 @@
 #include "reflection.h"
 #include "obj_list.h"
 #include "stddef.h"
+#include "string.h"
+
+#if OBJ_LIST_POOL_ENABLE == 1
+typedef struct obj_list_pool ObjListPool;
+
+/**
+ * @brief 对象链表节点池中的节点
+ *        记录分配节点的节点池，节点可以在其他线程释放
+ * 
+ */
+typedef struct
+{
+    ObjListPool *pool;                          /**< 所属节点池 */
+    ObjList node;                               /**< 节点 */
+} ObjListSlot;
+
+/**
+ * @brief 对象链表节点池内存块
+ * 
+ */
+typedef struct obj_list_chunk
+{
+    struct obj_list_chunk *next;                /**< 下一个内存块 */
+    ObjListSlot slots[OBJ_LIST_POOL_CHUNK_SIZE];/**< 节点 */
+} ObjListChunk;
+
+/**
+ * @brief 对象链表节点池
+ *        每个线程使用独立的节点池，其他线程释放的节点放入归还链表，由所属线程回收，
+ *        所属线程销毁节点池后，由最后一个归还节点的线程释放内存块
+ * 
+ */
+struct obj_list_pool
+{
+    ObjListChunk *chunks;                       /**< 已分配的内存块 */
+    ObjList *freeList;                          /**< 所属线程回收的空闲节点 */
+    size_t used;                                /**< 当前内存块已使用的节点数量 */
+    size_t live;                                /**< 未回收到空闲链表的节点数量，只由所属线程修改 */
+    ObjList *remoteList;                        /**< 其他线程归还的节点，加锁访问 */
+    size_t remoteCount;                         /**< 其他线程归还的节点数量，加锁访问 */
+    int detached;                               /**< 所属线程已销毁节点池，加锁访问 */
+};
+
+static REFLECT_THREAD_LOCAL ObjListPool *objListPool = NULL;
+
+
+/**
+ * @brief 释放节点池及其所有内存块
+ *        节点池的内存不经过线程绑定的分配器，可以在任意线程释放
+ * 
+ * @param pool 节点池
+ */
+static void objListPoolRelease(ObjListPool *pool)
+{
+    ReflectAllocator *allocator = reflectSetAllocator(NULL);
+    while (pool->chunks)
+    {
+        ObjListChunk *chunk = pool->chunks;
+        pool->chunks = chunk->next;
+        REFLECT_FREE(chunk);
+    }
+    REFLECT_FREE(pool);
+    reflectSetAllocator(allocator);
+}
+#endif
+
+
+/**
+ * @brief 分配对象链表节点
+ *        使能 OBJ_LIST_POOL_ENABLE 时从当前线程的节点池分配
+ * 
+ * @return ObjList* 节点，内存不足返回NULL
+ */
+ObjList *objListNodeAlloc(void)
+{
+#if OBJ_LIST_POOL_ENABLE == 1
+    ObjListPool *pool = objListPool;
+    if (!pool)
+    {
+        ReflectAllocator *allocator = reflectSetAllocator(NULL);
+        pool = REFLECT_MALLOC(sizeof(ObjListPool));
+        reflectSetAllocator(allocator);
+        REFLECT_ASSERT(pool, return NULL);
+        memset(pool, 0, sizeof(ObjListPool));
+        pool->used = OBJ_LIST_POOL_CHUNK_SIZE;
+        objListPool = pool;
+    }
+    if (!pool->freeList && pool->used == OBJ_LIST_POOL_CHUNK_SIZE)
+    {
+        /* 当前内存块用完时先回收其他线程归还的节点 */
+        OBJ_LIST_POOL_LOCK();
+        pool->freeList = pool->remoteList;
+        pool->live -= pool->remoteCount;
+        pool->remoteList = NULL;
+        pool->remoteCount = 0;
+        OBJ_LIST_POOL_UNLOCK();
+    }
+    ObjList *node = pool->freeList;
+    if (node)
+    {
+        pool->freeList = node->next;
+        pool->live++;
+        return node;
+    }
+    if (pool->used == OBJ_LIST_POOL_CHUNK_SIZE)
+    {
+        ReflectAllocator *allocator = reflectSetAllocator(NULL);
+        ObjListChunk *chunk = REFLECT_MALLOC(sizeof(ObjListChunk));
+        reflectSetAllocator(allocator);
+        REFLECT_ASSERT(chunk, return NULL);
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->used = 0;
+    }
+    ObjListSlot *slot = &pool->chunks->slots[pool->used++];
+    slot->pool = pool;
+    pool->live++;
+    return &slot->node;
+#else
+    return REFLECT_MALLOC(sizeof(ObjList));
+#endif
+}
+
+
+/**
+ * @brief 释放对象链表节点
+ *        使能 OBJ_LIST_POOL_ENABLE 时节点归还到分配节点的节点池
+ * 
+ * @param node 由 objListNodeAlloc 分配的节点
+ * @note 使能 OBJ_LIST_POOL_ENABLE 时节点前保存所属节点池，其他方式分配的节点不能使用该函数释放，
+ *       ObjList 的布局与序列化格式一致，无法在节点中标记来源
+ */
+void objListNodeFree(ObjList *node)
+{
+#if OBJ_LIST_POOL_ENABLE == 1
+    ObjListPool *pool = ((ObjListSlot *)((size_t)node - offsetof(ObjListSlot, node)))->pool;
+    if (pool == objListPool)
+    {
+        node->next = pool->freeList;
+        pool->freeList = node;
+        pool->live--;
+        return;
+    }
+    OBJ_LIST_POOL_LOCK();
+    node->next = pool->remoteList;
+    pool->remoteList = node;
+    pool->remoteCount++;
+    int release = pool->detached && pool->remoteCount == pool->live;
+    OBJ_LIST_POOL_UNLOCK();
+    if (release)
+    {
+        objListPoolRelease(pool);
+    }
+#else
+    REFLECT_FREE(node);
+#endif
+}
+
+
+/**
+ * @brief 销毁当前线程的节点池
+ *        节点都已释放时立即释放内存块，否则在最后一个节点释放时释放内存块
+ * 
+ * @note 线程退出前调用，之后当前线程再分配节点时创建新的节点池
+ */
+void objListPoolDestroy(void)
+{
+#if OBJ_LIST_POOL_ENABLE == 1
+    ObjListPool *pool = objListPool;
+    REFLECT_ASSERT(pool, return);
+    objListPool = NULL;
+    OBJ_LIST_POOL_LOCK();
+    pool->detached = 1;
+    int release = pool->remoteCount == pool->live;
+    OBJ_LIST_POOL_UNLOCK();
+    if (release)
+    {
+        objListPoolRelease(pool);
+    }
+#endif
+}
 
 
 /**
  * @brief 对象链表添加节点
  * 
  * @param list 链表
- * @param node 节点
+ * @param node 节点，使能 OBJ_LIST_POOL_ENABLE 时必须由 objListNodeAlloc 分配
  * @return ObjList* 链表
  */
 ObjList *objListAddNode(ObjList *list, ObjList *node)
@@ -50,14 +231,14 @@ ObjList *objListAdd(ObjList *list, void *obj)
 {
     if (!list)
     {
-        list = REFLECT_MALLOC(sizeof(ObjList));
+        list = objListNodeAlloc();
         REFLECT_ASSERT(list, return NULL);
         list->obj = obj;
         list->next = NULL;
         return list;
     }
 
-    ObjList *node = REFLECT_MALLOC(sizeof(ObjList));
+    ObjList *node = objListNodeAlloc();
     REFLECT_ASSERT(node, return list);
     node->obj = obj;
     return objListAddNode(list, node);
@@ -82,7 +263,8 @@ ObjList *objListDelNode(ObjList *list, ObjList *node)
     {
         if (p->next == node)
         {
-            p->next = p->next->next ? p->next->next : NULL;
+            p->next = node->next;
+            break;
         }
         p = p->next;
     }
@@ -92,6 +274,7 @@ ObjList *objListDelNode(ObjList *list, ObjList *node)
 
 /**
  * @brief 对象链表删除对象
+ *        删除所有匹配的节点，并释放节点内存
  * 
  * @param list 链表
  * @param obj 待删除的对象
@@ -109,9 +292,14 @@ ObjList *objListDel(ObjList *list, void *obj)
     {
         if (p->next->obj && p->next->obj == obj)
         {
-            p->next = p->next->next ? p->next->next : NULL;
+            ObjList *node = p->next;
+            p->next = node->next;
+            objListNodeFree(node);
+        }
+        else
+        {
+            p = p->next;
         }
-        p = p->next;
     }
     return head.next;
 }
@@ -136,3 +324,82 @@ size_t objListGetSize(ObjList *list)
     }
     return size;
 }
+
+
+/**
+ * @brief 对象链表头添加节点
+ * 
+ * @param list 链表头
+ * @param node 节点，使能 OBJ_LIST_POOL_ENABLE 时必须由 objListNodeAlloc 分配
+ * @return ObjList* 链表
+ */
+ObjList *objListHeadAddNode(ObjListHead *list, ObjList *node)
+{
+    node->next = NULL;
+    if (list->tail)
+    {
+        list->tail->next = node;
+    }
+    else
+    {
+        list->head = node;
+    }
+    list->tail = node;
+    list->size++;
+    return list->head;
+}
+
+
+/**
+ * @brief 对象链表头添加对象
+ * 
+ * @param list 链表头
+ * @param obj 对象
+ * @return ObjList* 链表，内存不足返回NULL
+ */
+ObjList *objListHeadAdd(ObjListHead *list, void *obj)
+{
+    ObjList *node = objListNodeAlloc();
+    REFLECT_ASSERT(node, return NULL);
+    node->obj = obj;
+    return objListHeadAddNode(list, node);
+}
+
+
+/**
+ * @brief 对象链表头删除对象
+ *        删除第一个匹配的节点，并释放节点内存
+ * 
+ * @param list 链表头
+ * @param obj 待删除的对象
+ * @return ObjList* 对象删除后的链表
+ */
+ObjList *objListHeadDel(ObjListHead *list, void *obj)
+{
+    ObjList *prev = NULL;
+    ObjList *p = list->head;
+    while (p)
+    {
+        if (p->obj == obj)
+        {
+            if (prev)
+            {
+                prev->next = p->next;
+            }
+            else
+            {
+                list->head = p->next;
+            }
+            if (list->tail == p)
+            {
+                list->tail = prev;
+            }
+            list->size--;
+            objListNodeFree(p);
+            break;
+        }
+        prev = p;
+        p = p->next;
+    }
+    return list->head;
+}
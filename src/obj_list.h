@@ -11,6 +11,8 @@
 #ifndef __OBJ_LIST_H__
 #define __OBJ_LIST_H__
 
+#include "stddef.h"
+
 /**
  * @defgroup OBJ_LIST object_list
  * @brief object list
@@ -28,11 +30,50 @@ typedef struct obj_lsit
     struct obj_lsit *next;                      /**< 下一个节点指针 */
 } ObjList;
 
+/**
+ * @brief 对象链表头
+ *        记录链表尾节点和节点数量，添加对象和获取大小都是O(1)操作
+ * 
+ * @note 零初始化即为空链表，链表本身仍然是 ObjList，可以直接使用 head 作为 ObjList *
+ */
+typedef struct
+{
+    ObjList *head;                              /**< 头节点 */
+    ObjList *tail;                              /**< 尾节点 */
+    size_t size;                                /**< 节点数量 */
+} ObjListHead;
+
+/**
+ * @brief 分配对象链表节点
+ *        使能 OBJ_LIST_POOL_ENABLE 时从当前线程的节点池分配
+ * 
+ * @return ObjList* 节点，内存不足返回NULL
+ */
+ObjList *objListNodeAlloc(void);
+
+/**
+ * @brief 释放对象链表节点
+ *        使能 OBJ_LIST_POOL_ENABLE 时节点归还到分配节点的节点池
+ * 
+ * @param node 由 objListNodeAlloc 分配的节点
+ * @note 使能 OBJ_LIST_POOL_ENABLE 时节点前保存所属节点池，其他方式分配的节点不能使用该函数释放，
+ *       ObjList 的布局与序列化格式一致，无法在节点中标记来源
+ */
+void objListNodeFree(ObjList *node);
+
+/**
+ * @brief 销毁当前线程的节点池
+ *        节点都已释放时立即释放内存块，否则在最后一个节点释放时释放内存块
+ * 
+ * @note 线程退出前调用，之后当前线程再分配节点时创建新的节点池
+ */
+void objListPoolDestroy(void);
+
 /**
  * @brief 对象链表添加节点
  * 
  * @param list 链表
- * @param node 节点
+ * @param node 节点，使能 OBJ_LIST_POOL_ENABLE 时必须由 objListNodeAlloc 分配
  * @return ObjList* 链表
  */
 ObjList *objListAddNode(ObjList *list, ObjList *node);
@@ -57,6 +98,7 @@ ObjList *objListDelNode(ObjList *list, ObjList *node);
 
 /**
  * @brief 对象链表删除对象
+ *        删除所有匹配的节点，并释放节点内存
  * 
  * @param list 链表
  * @param obj 待删除的对象
@@ -72,6 +114,42 @@ ObjList *objListDel(ObjList *list, void *obj);
  */
 size_t objListGetSize(ObjList *list);
 
+/**
+ * @brief 对象链表头添加节点
+ * 
+ * @param list 链表头
+ * @param node 节点，使能 OBJ_LIST_POOL_ENABLE 时必须由 objListNodeAlloc 分配
+ * @return ObjList* 链表
+ */
+ObjList *objListHeadAddNode(ObjListHead *list, ObjList *node);
+
+/**
+ * @brief 对象链表头添加对象
+ * 
+ * @param list 链表头
+ * @param obj 对象
+ * @return ObjList* 链表，内存不足返回NULL
+ */
+ObjList *objListHeadAdd(ObjListHead *list, void *obj);
+
+/**
+ * @brief 对象链表头删除对象
+ *        删除第一个匹配的节点，并释放节点内存
+ * 
+ * @param list 链表头
+ * @param obj 待删除的对象
+ * @return ObjList* 对象删除后的链表
+ */
+ObjList *objListHeadDel(ObjListHead *list, void *obj);
+
+/**
+ * @brief 获取链表头记录的链表大小
+ * 
+ * @param list 链表头
+ */
+#define objListHeadGetSize(list) \
+        ((list)->size)
+
 /**
  * @}
  */
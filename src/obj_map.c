@@ -0,0 +1,191 @@
+/**
+ * @file obj_map.c
+ * @author agent
+ * @brief object map
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "reflection.h"
+#include "obj_map.h"
+#include "string.h"
+
+#define OBJ_MAP_MIN_CAPACITY    16
+
+
+/**
+ * @brief 对象地址哈希
+ *
+ * @param key 键
+ * @return size_t 哈希值
+ */
+static size_t objMapHash(void *key)
+{
+    size_t h = (size_t)key >> 3;
+    h ^= h >> 15;
+    h *= (size_t)0x2c1b3c6dUL;
+    h ^= h >> 12;
+    return h;
+}
+
+
+/**
+ * @brief 对象映射表扩容
+ *
+ * @param map 映射表
+ * @param capacity 新容量
+ * @return int 0 成功 -1 内存不足
+ */
+static int objMapResize(ObjMap *map, size_t capacity)
+{
+    ObjMapEntry *entries = REFLECT_MALLOC(sizeof(ObjMapEntry) * capacity);
+    REFLECT_ASSERT(entries, return -1);
+    memset(entries, 0, sizeof(ObjMapEntry) * capacity);
+
+    for (size_t i = 0; i < map->capacity; i++)
+    {
+        if (map->entries[i].key)
+        {
+            size_t index = objMapHash(map->entries[i].key) & (capacity - 1);
+            while (entries[index].key)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+            entries[index] = map->entries[i];
+        }
+    }
+
+    if (map->entries)
+    {
+        REFLECT_FREE(map->entries);
+    }
+    map->entries = entries;
+    map->capacity = capacity;
+    return 0;
+}
+
+
+/**
+ * @brief 对象映射表查找
+ *
+ * @param map 映射表
+ * @param key 键
+ * @return ObjMapEntry* 找到的表项，未找到返回NULL
+ */
+ObjMapEntry *objMapFind(ObjMap *map, void *key)
+{
+    REFLECT_ASSERT(map->size, return NULL);
+
+    size_t index = objMapHash(key) & (map->capacity - 1);
+    while (map->entries[index].key)
+    {
+        if (map->entries[index].key == key)
+        {
+            return &map->entries[index];
+        }
+        index = (index + 1) & (map->capacity - 1);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief 对象映射表获取值
+ *
+ * @param map 映射表
+ * @param key 键
+ * @return void* 值，未找到返回NULL
+ */
+void *objMapGet(ObjMap *map, void *key)
+{
+    ObjMapEntry *entry = objMapFind(map, key);
+    return entry ? entry->value : NULL;
+}
+
+
+/**
+ * @brief 对象映射表添加(或更新)键值
+ *
+ * @param map 映射表
+ * @param key 键，不可为NULL
+ * @param value 值
+ * @return int 0 成功 -1 内存不足
+ */
+int objMapPut(ObjMap *map, void *key, void *value)
+{
+    if ((map->size + 1) * 4 > map->capacity * 3)
+    {
+        if (objMapResize(map, map->capacity ? map->capacity * 2 : OBJ_MAP_MIN_CAPACITY) != 0)
+        {
+            return -1;
+        }
+    }
+
+    size_t index = objMapHash(key) & (map->capacity - 1);
+    while (map->entries[index].key)
+    {
+        if (map->entries[index].key == key)
+        {
+            map->entries[index].value = value;
+            return 0;
+        }
+        index = (index + 1) & (map->capacity - 1);
+    }
+    map->entries[index].key = key;
+    map->entries[index].value = value;
+    map->size++;
+    return 0;
+}
+
+
+/**
+ * @brief 对象映射表删除键
+ *        删除后将同一探测序列中后续的表项前移，不使用删除标记
+ *
+ * @param map 映射表
+ * @param key 键
+ * @return int 0 成功 -1 未找到
+ */
+int objMapRemove(ObjMap *map, void *key)
+{
+    ObjMapEntry *entry = objMapFind(map, key);
+    REFLECT_ASSERT(entry, return -1);
+
+    size_t mask = map->capacity - 1;
+    size_t hole = entry - map->entries;
+    size_t index = (hole + 1) & mask;
+    while (map->entries[index].key)
+    {
+        size_t home = objMapHash(map->entries[index].key) & mask;
+        /* 空位在表项的初始位置和当前位置之间时，表项可以前移到空位 */
+        if (((index - home) & mask) >= ((index - hole) & mask))
+        {
+            map->entries[hole] = map->entries[index];
+            hole = index;
+        }
+        index = (index + 1) & mask;
+    }
+    map->entries[hole].key = NULL;
+    map->entries[hole].value = NULL;
+    map->size--;
+    return 0;
+}
+
+
+/**
+ * @brief 清空对象映射表，释放表项内存
+ *
+ * @param map 映射表
+ */
+void objMapClear(ObjMap *map)
+{
+    if (map->entries)
+    {
+        REFLECT_FREE(map->entries);
+    }
+    map->entries = NULL;
+    map->capacity = 0;
+    map->size = 0;
+}
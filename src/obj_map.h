@@ -0,0 +1,93 @@
+/**
+ * @file obj_map.h
+ * @author agent
+ * @brief object map
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#ifndef __OBJ_MAP_H__
+#define __OBJ_MAP_H__
+
+#include "stddef.h"
+
+/**
+ * @defgroup OBJ_MAP object_map
+ * @brief object map
+ * @addtogroup OBJ_MAP
+ * @{
+ */
+
+/**
+ * @brief 对象映射表项
+ *
+ */
+typedef struct
+{
+    void *key;                                  /**< 键(对象地址), NULL 表示空项 */
+    void *value;                                /**< 值 */
+} ObjMapEntry;
+
+/**
+ * @brief 对象映射表(以对象地址为键的开放寻址哈希表)
+ *
+ * @note 零初始化的 ObjMap 即为空表，可以直接使用
+ */
+typedef struct
+{
+    ObjMapEntry *entries;                       /**< 表项 */
+    size_t capacity;                            /**< 容量(2的幂) */
+    size_t size;                                /**< 已使用的表项数量 */
+} ObjMap;
+
+/**
+ * @brief 对象映射表查找
+ *
+ * @param map 映射表
+ * @param key 键
+ * @return ObjMapEntry* 找到的表项，未找到返回NULL
+ */
+ObjMapEntry *objMapFind(ObjMap *map, void *key);
+
+/**
+ * @brief 对象映射表获取值
+ *
+ * @param map 映射表
+ * @param key 键
+ * @return void* 值，未找到返回NULL
+ */
+void *objMapGet(ObjMap *map, void *key);
+
+/**
+ * @brief 对象映射表添加(或更新)键值
+ *
+ * @param map 映射表
+ * @param key 键，不可为NULL
+ * @param value 值
+ * @return int 0 成功 -1 内存不足
+ */
+int objMapPut(ObjMap *map, void *key, void *value);
+
+/**
+ * @brief 对象映射表删除键
+ *
+ * @param map 映射表
+ * @param key 键
+ * @return int 0 成功 -1 未找到
+ */
+int objMapRemove(ObjMap *map, void *key);
+
+/**
+ * @brief 清空对象映射表，释放表项内存
+ *
+ * @param map 映射表
+ */
+void objMapClear(ObjMap *map);
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,333 @@
+/**
+ * @file reflect_alloc.c
+ * @author agent
+ * @brief reflection allocator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#define REFLECT_ALLOC_IMPL
+#include "reflection.h"
+#include "reflect_alloc.h"
+#include "string.h"
+
+#if REFLECT_CACHE_CHUNK_SIZE < REFLECT_CACHE_MAX_SIZE * 2
+#error "REFLECT_CACHE_CHUNK_SIZE must be at least twice REFLECT_CACHE_MAX_SIZE"
+#endif
+
+/**
+ * @brief 线程缓存分配器内存块头
+ *        记录内存块的大小级别，同时保证用户内存的对齐
+ *
+ */
+typedef union
+{
+    size_t sizeClass;                           /**< 大小级别，REFLECT_CACHE_CLASS_COUNT 表示直接分配 */
+    long double align;
+    void *ptr;
+} ReflectCacheHeader;
+
+static REFLECT_THREAD_LOCAL ReflectAllocator *reflectAllocator = NULL;
+
+
+/**
+ * @brief 绑定当前线程的内存分配器
+ *
+ * @param allocator 内存分配器，NULL 表示使用 reflection_cfg.h 中配置的函数
+ * @return ReflectAllocator* 之前绑定的内存分配器
+ */
+ReflectAllocator *reflectSetAllocator(ReflectAllocator *allocator)
+{
+    ReflectAllocator *previous = reflectAllocator;
+    reflectAllocator = allocator;
+    return previous;
+}
+
+
+/**
+ * @brief 获取当前线程绑定的内存分配器
+ *
+ * @return ReflectAllocator* 内存分配器，未绑定返回NULL
+ */
+ReflectAllocator *reflectGetAllocator(void)
+{
+    return reflectAllocator;
+}
+
+
+/**
+ * @brief 使用当前线程绑定的分配器分配内存
+ *
+ * @param size 大小
+ * @return void* 内存地址，内存不足返回NULL
+ */
+void *reflectMalloc(size_t size)
+{
+    ReflectAllocator *allocator = reflectAllocator;
+    if (allocator)
+    {
+        return allocator->alloc(allocator->context, size);
+    }
+    return REFLECT_MALLOC(size);
+}
+
+
+/**
+ * @brief 使用当前线程绑定的分配器释放内存
+ *
+ * @param ptr 内存地址，可为NULL
+ */
+void reflectFree(void *ptr)
+{
+    REFLECT_ASSERT(ptr, return);
+    ReflectAllocator *allocator = reflectAllocator;
+    if (allocator)
+    {
+        allocator->free(allocator->context, ptr);
+        return;
+    }
+    REFLECT_FREE(ptr);
+}
+
+
+/**
+ * @brief 计算大小级别
+ *        128 以内按 16 字节递增，之后每个 2 的幂区间分为 4 级
+ *
+ * @param size 大小，不超过 REFLECT_CACHE_MAX_SIZE
+ * @return size_t 大小级别
+ */
+static size_t reflectCacheClass(size_t size)
+{
+    if (size <= 128)
+    {
+        return size ? (size - 1) >> 4 : 0;
+    }
+    size_t s = size - 1;
+    size_t bit = 7;
+    while (s >> (bit + 1))
+    {
+        bit++;
+    }
+    return 8 + (bit - 7) * 4 + ((s >> (bit - 2)) & 3);
+}
+
+
+/**
+ * @brief 计算大小级别的内存大小
+ *
+ * @param index 大小级别
+ * @return size_t 内存大小
+ */
+static size_t reflectCacheClassSize(size_t index)
+{
+    if (index < 8)
+    {
+        return (index + 1) * 16;
+    }
+    size_t group = (index - 8) / 4;
+    return ((size_t)128 << group) + ((index - 8) % 4 + 1) * ((size_t)32 << group);
+}
+
+
+/**
+ * @brief 为仓库分配新的内存块，切分为指定大小级别的空闲内存块
+ *        在 REFLECT_CACHE_LOCK 内调用
+ *
+ * @param depot 内存块仓库
+ * @param index 大小级别
+ * @return int 0 成功 -1 内存不足
+ */
+static int reflectCacheCarve(ReflectCacheDepot *depot, size_t index)
+{
+    size_t blockSize = sizeof(ReflectCacheHeader) + reflectCacheClassSize(index);
+    char *chunk = REFLECT_MALLOC(REFLECT_CACHE_CHUNK_SIZE);
+    REFLECT_ASSERT(chunk, return -1);
+    /* 内存块开头保存内存块链表 */
+    *(void **)chunk = depot->chunks;
+    depot->chunks = chunk;
+    char *end = chunk + REFLECT_CACHE_CHUNK_SIZE;
+    for (char *p = chunk + sizeof(ReflectCacheHeader); p + blockSize <= end; p += blockSize)
+    {
+        ReflectCacheBlock *block = (ReflectCacheBlock *)p;
+        block->next = depot->free[index];
+        depot->free[index] = block;
+        depot->count[index]++;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 从仓库获取一批空闲内存块
+ *
+ * @param cache 线程缓存
+ * @param index 大小级别
+ * @return int 0 成功 -1 内存不足
+ */
+static int reflectCacheFetch(ReflectThreadCache *cache, size_t index)
+{
+    ReflectCacheDepot *depot = cache->depot;
+    REFLECT_CACHE_LOCK();
+    if (!depot->free[index] && reflectCacheCarve(depot, index) != 0)
+    {
+        REFLECT_CACHE_UNLOCK();
+        return -1;
+    }
+    ReflectCacheBlock *head = depot->free[index];
+    ReflectCacheBlock *tail = head;
+    size_t count = 1;
+    while (count < REFLECT_CACHE_BATCH && tail->next)
+    {
+        tail = tail->next;
+        count++;
+    }
+    depot->free[index] = tail->next;
+    depot->count[index] -= count;
+    REFLECT_CACHE_UNLOCK();
+
+    tail->next = cache->free[index];
+    cache->free[index] = head;
+    cache->count[index] += count;
+    return 0;
+}
+
+
+/**
+ * @brief 归还空闲内存块到仓库
+ *
+ * @param cache 线程缓存
+ * @param index 大小级别
+ * @param count 归还的数量，不超过缓存中的数量
+ */
+static void reflectCacheRelease(ReflectThreadCache *cache, size_t index, size_t count)
+{
+    REFLECT_ASSERT(count, return);
+    ReflectCacheBlock *head = cache->free[index];
+    ReflectCacheBlock *tail = head;
+    for (size_t i = 1; i < count; i++)
+    {
+        tail = tail->next;
+    }
+    cache->free[index] = tail->next;
+    cache->count[index] -= count;
+
+    ReflectCacheDepot *depot = cache->depot;
+    REFLECT_CACHE_LOCK();
+    tail->next = depot->free[index];
+    depot->free[index] = head;
+    depot->count[index] += count;
+    REFLECT_CACHE_UNLOCK();
+}
+
+
+/**
+ * @brief 线程缓存分配内存
+ *
+ * @param context 线程缓存
+ * @param size 大小
+ * @return void* 内存地址，内存不足返回NULL
+ */
+static void *reflectCacheAlloc(void *context, size_t size)
+{
+    ReflectThreadCache *cache = context;
+    ReflectCacheHeader *header;
+    if (size > REFLECT_CACHE_MAX_SIZE)
+    {
+        header = REFLECT_MALLOC(sizeof(ReflectCacheHeader) + size);
+        REFLECT_ASSERT(header, return NULL);
+        header->sizeClass = REFLECT_CACHE_CLASS_COUNT;
+        return header + 1;
+    }
+    size_t index = reflectCacheClass(size);
+    if (!cache->free[index] && reflectCacheFetch(cache, index) != 0)
+    {
+        return NULL;
+    }
+    ReflectCacheBlock *block = cache->free[index];
+    cache->free[index] = block->next;
+    cache->count[index]--;
+    header = (ReflectCacheHeader *)block;
+    header->sizeClass = index;
+    return header + 1;
+}
+
+
+/**
+ * @brief 线程缓存释放内存
+ *        空闲内存块超过两批时归还一批到仓库
+ *
+ * @param context 线程缓存
+ * @param ptr 内存地址
+ */
+static void reflectCacheFree(void *context, void *ptr)
+{
+    ReflectThreadCache *cache = context;
+    ReflectCacheHeader *header = (ReflectCacheHeader *)ptr - 1;
+    size_t index = header->sizeClass;
+    if (index >= REFLECT_CACHE_CLASS_COUNT)
+    {
+        REFLECT_FREE(header);
+        return;
+    }
+    ReflectCacheBlock *block = (ReflectCacheBlock *)header;
+    block->next = cache->free[index];
+    cache->free[index] = block;
+    if (++cache->count[index] > REFLECT_CACHE_BATCH * 2)
+    {
+        reflectCacheRelease(cache, index, REFLECT_CACHE_BATCH);
+    }
+}
+
+
+/**
+ * @brief 初始化线程缓存分配器
+ *
+ * @param cache 线程缓存
+ * @param depot 内存块仓库
+ */
+void reflectCacheInit(ReflectThreadCache *cache, ReflectCacheDepot *depot)
+{
+    memset(cache, 0, sizeof(ReflectThreadCache));
+    cache->allocator.alloc = reflectCacheAlloc;
+    cache->allocator.free = reflectCacheFree;
+    cache->allocator.context = cache;
+    cache->depot = depot;
+}
+
+
+/**
+ * @brief 将线程缓存中的空闲内存块归还到仓库
+ *
+ * @param cache 线程缓存
+ */
+void reflectCacheFlush(ReflectThreadCache *cache)
+{
+    for (size_t i = 0; i < REFLECT_CACHE_CLASS_COUNT; i++)
+    {
+        if (cache->count[i])
+        {
+            reflectCacheRelease(cache, i, cache->count[i]);
+        }
+    }
+}
+
+
+/**
+ * @brief 释放仓库的所有内存块
+ *
+ * @param depot 内存块仓库
+ */
+void reflectCacheDepotDestroy(ReflectCacheDepot *depot)
+{
+    void *chunk = depot->chunks;
+    while (chunk)
+    {
+        void *next = *(void **)chunk;
+        REFLECT_FREE(chunk);
+        chunk = next;
+    }
+    memset(depot, 0, sizeof(ReflectCacheDepot));
+}
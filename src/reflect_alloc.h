@@ -0,0 +1,145 @@
+/**
+ * @file reflect_alloc.h
+ * @author agent
+ * @brief reflection allocator
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#ifndef __REFLECT_ALLOC_H__
+#define __REFLECT_ALLOC_H__
+
+#include "stddef.h"
+#include "reflection_cfg.h"
+
+/**
+ * @defgroup REFLECT_ALLOC reflect_alloc
+ * @brief reflection allocator
+ * @addtogroup REFLECT_ALLOC
+ * @{
+ */
+
+#define REFLECT_CACHE_CLASS_COUNT       24      /**< 线程缓存分配器的大小级别数量 */
+#define REFLECT_CACHE_MAX_SIZE          2048    /**< 线程缓存分配器缓存的最大分配大小 */
+
+/* 库中的内存分配经过当前线程绑定的分配器，分配器实现和统计实现中使用配置的函数 */
+#if !defined(REFLECT_ALLOC_IMPL) && !defined(REFLECT_STATS_IMPL)
+#undef REFLECT_MALLOC
+#undef REFLECT_FREE
+#define REFLECT_MALLOC          reflectMalloc
+#define REFLECT_FREE            reflectFree
+#endif
+
+/**
+ * @brief 内存分配器
+ *
+ */
+typedef struct
+{
+    void *(*alloc)(void *context, size_t size); /**< 内存分配函数 */
+    void (*free)(void *context, void *ptr);     /**< 内存释放函数 */
+    void *context;                              /**< 用户上下文 */
+} ReflectAllocator;
+
+/**
+ * @brief 线程缓存分配器空闲内存块
+ *
+ */
+typedef struct reflect_cache_block
+{
+    struct reflect_cache_block *next;           /**< 下一个空闲内存块 */
+} ReflectCacheBlock;
+
+/**
+ * @brief 线程缓存分配器内存块仓库
+ *        多个线程的缓存共享一个仓库，缓存以批为单位从仓库获取和归还空闲内存块
+ *
+ * @note 零初始化即为空仓库
+ */
+typedef struct
+{
+    ReflectCacheBlock *free[REFLECT_CACHE_CLASS_COUNT]; /**< 各大小级别的空闲内存块 */
+    size_t count[REFLECT_CACHE_CLASS_COUNT];    /**< 各大小级别的空闲内存块数量 */
+    void *chunks;                               /**< 已分配的内存块 */
+} ReflectCacheDepot;
+
+/**
+ * @brief 线程缓存分配器
+ *        每个线程(工作线程)使用独立的缓存，分配和释放不需要加锁
+ *
+ */
+typedef struct
+{
+    ReflectAllocator allocator;                 /**< 分配器接口，context 指向本缓存 */
+    ReflectCacheDepot *depot;                   /**< 内存块仓库 */
+    ReflectCacheBlock *free[REFLECT_CACHE_CLASS_COUNT]; /**< 各大小级别的空闲内存块 */
+    size_t count[REFLECT_CACHE_CLASS_COUNT];    /**< 各大小级别的空闲内存块数量 */
+} ReflectThreadCache;
+
+/**
+ * @brief 绑定当前线程的内存分配器
+ *        之后当前线程中 REFLECT_MALLOC 和 REFLECT_FREE 使用该分配器
+ *
+ * @param allocator 内存分配器，NULL 表示使用 reflection_cfg.h 中配置的函数
+ * @return ReflectAllocator* 之前绑定的内存分配器
+ * @note 对象需要在绑定同一个分配器(或者同一个仓库的线程缓存)时释放，
+ *       多线程环境下需要配置 REFLECT_THREAD_LOCAL
+ */
+ReflectAllocator *reflectSetAllocator(ReflectAllocator *allocator);
+
+/**
+ * @brief 获取当前线程绑定的内存分配器
+ *
+ * @return ReflectAllocator* 内存分配器，未绑定返回NULL
+ */
+ReflectAllocator *reflectGetAllocator(void);
+
+/**
+ * @brief 使用当前线程绑定的分配器分配内存
+ *        REFLECT_MALLOC 替换为该函数
+ *
+ * @param size 大小
+ * @return void* 内存地址，内存不足返回NULL
+ */
+void *reflectMalloc(size_t size);
+
+/**
+ * @brief 使用当前线程绑定的分配器释放内存
+ *        REFLECT_FREE 替换为该函数
+ *
+ * @param ptr 内存地址，可为NULL
+ */
+void reflectFree(void *ptr);
+
+/**
+ * @brief 初始化线程缓存分配器
+ *        不超过 REFLECT_CACHE_MAX_SIZE 的内存按大小级别从缓存分配，更大的内存直接分配
+ *
+ * @param cache 线程缓存
+ * @param depot 内存块仓库
+ */
+void reflectCacheInit(ReflectThreadCache *cache, ReflectCacheDepot *depot);
+
+/**
+ * @brief 将线程缓存中的空闲内存块归还到仓库
+ *        线程退出前调用
+ *
+ * @param cache 线程缓存
+ */
+void reflectCacheFlush(ReflectThreadCache *cache);
+
+/**
+ * @brief 释放仓库的所有内存块
+ *
+ * @param depot 内存块仓库
+ * @note 调用前必须保证从该仓库分配的内存都已不再使用，所有线程缓存都已归还或不再使用
+ */
+void reflectCacheDepotDestroy(ReflectCacheDepot *depot);
+
+/**
+ * @}
+ */
+
+#endif
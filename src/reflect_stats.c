@@ -0,0 +1,623 @@
+/**
+ * @file reflect_stats.c
+ * @author agent
+ * @brief reflection runtime statistics
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#define REFLECT_STATS_IMPL
+#include "reflection.h"
+#include "reflect_stats.h"
+#include "string.h"
+#include "time.h"
+
+#define REFLECT_STATS_TABLE_MIN_SIZE    16      /**< 模型统计哈希表最小容量 */
+
+static const char *reflectStatsOpNames[REFLECT_STATS_OP_COUNT] =
+{
+    "serialize",
+    "deserialize",
+    "free",
+    "json_encode",
+    "json_decode",
+};
+
+#if REFLECT_STATS_ENABLE == 1
+/**
+ * @brief 模型统计
+ *
+ */
+typedef struct
+{
+    Reflection *model;                          /**< Reflection 模型，NULL表示空位 */
+    ReflectStatsCounter ops[REFLECT_STATS_OP_COUNT]; /**< 各操作计数 */
+} ReflectStatsEntry;
+
+/**
+ * @brief 模型统计哈希表(开放寻址)
+ *
+ */
+typedef struct
+{
+    ReflectStatsEntry *entries;                 /**< 模型统计 */
+    size_t capacity;                            /**< 容量(2的幂) */
+    size_t size;                                /**< 模型数量 */
+} ReflectStatsTable;
+
+/**
+ * @brief 线程统计分片
+ *        每个线程只写入自己的分片，快照时合并所有分片，
+ *        分片在线程退出后保留，已退出线程的统计仍计入快照
+ *
+ */
+typedef struct reflect_stats_shard
+{
+    struct reflect_stats_shard *next;           /**< 下一个分片 */
+    ReflectStats stats;                         /**< 全局统计 */
+    ReflectStatsTable models;                   /**< 模型统计 */
+    ReflectStatsScope *scope;                   /**< 当前操作 */
+    size_t depth;                               /**< 当前遍历深度 */
+} ReflectStatsShard;
+
+static REFLECT_THREAD_LOCAL ReflectStatsShard *reflectStatsCurrent = NULL;
+static ReflectStatsShard *reflectStatsShards = NULL;
+
+
+/**
+ * @brief 获取当前线程的统计分片
+ *        首次使用时创建并加入分片链表
+ *
+ * @return ReflectStatsShard* 统计分片，内存不足返回NULL
+ */
+static ReflectStatsShard *reflectStatsGetShard(void)
+{
+    ReflectStatsShard *shard = reflectStatsCurrent;
+    if (!shard)
+    {
+        shard = REFLECT_MALLOC(sizeof(ReflectStatsShard));
+        REFLECT_ASSERT(shard, return NULL);
+        memset(shard, 0, sizeof(ReflectStatsShard));
+        REFLECT_LOCK();
+        shard->next = reflectStatsShards;
+        reflectStatsShards = shard;
+        REFLECT_UNLOCK();
+        reflectStatsCurrent = shard;
+    }
+    return shard;
+}
+
+
+/**
+ * @brief 累加计数
+ *        计数只由所属线程写入，读取和写入分开进行，不需要原子的读-改-写
+ *
+ * @param var 计数
+ * @param value 累加的值
+ */
+static void reflectStatsInc(uint64_t *var, uint64_t value)
+{
+    REFLECT_STATS_STORE(var, REFLECT_STATS_LOAD(var) + value);
+}
+
+
+/**
+ * @brief 累加操作计数
+ *
+ * @param dest 目标计数
+ * @param src 累加的计数
+ */
+static void reflectStatsAdd(ReflectStatsCounter *dest, const ReflectStatsCounter *src)
+{
+    reflectStatsInc(&dest->calls, REFLECT_STATS_LOAD(&src->calls));
+    reflectStatsInc(&dest->bytesIn, REFLECT_STATS_LOAD(&src->bytesIn));
+    reflectStatsInc(&dest->bytesOut, REFLECT_STATS_LOAD(&src->bytesOut));
+    reflectStatsInc(&dest->allocs, REFLECT_STATS_LOAD(&src->allocs));
+    reflectStatsInc(&dest->frees, REFLECT_STATS_LOAD(&src->frees));
+    reflectStatsInc(&dest->allocBytes, REFLECT_STATS_LOAD(&src->allocBytes));
+    reflectStatsInc(&dest->timeNs, REFLECT_STATS_LOAD(&src->timeNs));
+    uint64_t maxDepth = REFLECT_STATS_LOAD(&src->maxDepth);
+    if (maxDepth > REFLECT_STATS_LOAD(&dest->maxDepth))
+    {
+        REFLECT_STATS_STORE(&dest->maxDepth, maxDepth);
+    }
+}
+
+
+/**
+ * @brief 清零操作计数
+ *
+ * @param counter 操作计数
+ * @param count 操作计数数量
+ */
+static void reflectStatsClear(ReflectStatsCounter *counter, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        REFLECT_STATS_STORE(&counter[i].calls, 0);
+        REFLECT_STATS_STORE(&counter[i].bytesIn, 0);
+        REFLECT_STATS_STORE(&counter[i].bytesOut, 0);
+        REFLECT_STATS_STORE(&counter[i].allocs, 0);
+        REFLECT_STATS_STORE(&counter[i].frees, 0);
+        REFLECT_STATS_STORE(&counter[i].allocBytes, 0);
+        REFLECT_STATS_STORE(&counter[i].timeNs, 0);
+        REFLECT_STATS_STORE(&counter[i].maxDepth, 0);
+    }
+}
+
+
+/**
+ * @brief 模型地址哈希
+ *
+ * @param model Reflection 模型
+ * @return size_t 哈希值
+ */
+static size_t reflectStatsHash(Reflection *model)
+{
+    uint64_t hash = (uint64_t)(size_t)model;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return (size_t)hash;
+}
+
+
+/**
+ * @brief 查找模型统计
+ *
+ * @param table 模型统计哈希表
+ * @param model Reflection 模型
+ * @return ReflectStatsEntry* 模型统计，不存在返回NULL
+ */
+static ReflectStatsEntry *reflectStatsTableFind(ReflectStatsTable *table, Reflection *model)
+{
+    if (!table->entries)
+    {
+        return NULL;
+    }
+    for (size_t i = reflectStatsHash(model) & (table->capacity - 1); ;
+         i = (i + 1) & (table->capacity - 1))
+    {
+        if (table->entries[i].model == model)
+        {
+            return &table->entries[i];
+        }
+        if (!table->entries[i].model)
+        {
+            return NULL;
+        }
+    }
+}
+
+
+/**
+ * @brief 获取模型统计
+ *        不存在时插入，负载超过3/4时扩容
+ *
+ * @param table 模型统计哈希表
+ * @param model Reflection 模型
+ * @return ReflectStatsEntry* 模型统计，内存不足返回NULL
+ */
+static ReflectStatsEntry *reflectStatsTableGet(ReflectStatsTable *table, Reflection *model)
+{
+    ReflectStatsEntry *entry = reflectStatsTableFind(table, model);
+    if (entry)
+    {
+        return entry;
+    }
+    if ((table->size + 1) * 4 > table->capacity * 3)
+    {
+        size_t capacity = table->capacity ? table->capacity * 2 : REFLECT_STATS_TABLE_MIN_SIZE;
+        ReflectStatsEntry *entries = REFLECT_MALLOC(sizeof(ReflectStatsEntry) * capacity);
+        REFLECT_ASSERT(entries, return NULL);
+        memset(entries, 0, sizeof(ReflectStatsEntry) * capacity);
+        for (size_t i = 0; i < table->capacity; i++)
+        {
+            if (table->entries[i].model)
+            {
+                size_t j = reflectStatsHash(table->entries[i].model) & (capacity - 1);
+                while (entries[j].model)
+                {
+                    j = (j + 1) & (capacity - 1);
+                }
+                entries[j] = table->entries[i];
+            }
+        }
+        if (table->entries)
+        {
+            REFLECT_FREE(table->entries);
+        }
+        table->entries = entries;
+        table->capacity = capacity;
+    }
+    size_t i = reflectStatsHash(model) & (table->capacity - 1);
+    while (table->entries[i].model)
+    {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    table->entries[i].model = model;
+    table->size++;
+    return &table->entries[i];
+}
+
+
+/**
+ * @brief 统计内存分配
+ *        使能 REFLECT_STATS_ENABLE 时 REFLECT_MALLOC 替换为该函数
+ *
+ * @param size 大小
+ * @return void* 内存地址
+ */
+void *reflectStatsMalloc(size_t size)
+{
+    /* 内存分配可能发生在 REFLECT_LOCK 内(例如编译执行计划)，这里不创建分片 */
+    ReflectStatsShard *shard = reflectStatsCurrent;
+    void *ptr = reflectMalloc(size);
+    if (ptr && shard)
+    {
+        reflectStatsInc(&shard->stats.allocs, 1);
+        reflectStatsInc(&shard->stats.allocBytes, size);
+    }
+    return ptr;
+}
+
+
+/**
+ * @brief 统计内存释放
+ *        使能 REFLECT_STATS_ENABLE 时 REFLECT_FREE 替换为该函数
+ *
+ * @param ptr 内存地址
+ */
+void reflectStatsFree(void *ptr)
+{
+    ReflectStatsShard *shard = reflectStatsCurrent;
+    if (ptr && shard)
+    {
+        reflectStatsInc(&shard->stats.frees, 1);
+    }
+    reflectFree(ptr);
+}
+
+
+/**
+ * @brief 开始统计操作
+ *
+ * @param scope 统计范围，操作结束前有效
+ * @param model Reflection 模型
+ * @param op 操作
+ */
+void reflectStatsBegin(ReflectStatsScope *scope, Reflection *model, ReflectStatsOp op)
+{
+    ReflectStatsShard *shard = reflectStatsGetShard();
+    scope->shard = shard;
+    REFLECT_ASSERT(shard, return);
+    scope->parent = shard->scope;
+    scope->model = model;
+    scope->op = op;
+    scope->allocs = REFLECT_STATS_LOAD(&shard->stats.allocs);
+    scope->frees = REFLECT_STATS_LOAD(&shard->stats.frees);
+    scope->allocBytes = REFLECT_STATS_LOAD(&shard->stats.allocBytes);
+    scope->depth = shard->depth;
+    scope->maxDepth = 0;
+    shard->scope = scope;
+    scope->start = REFLECT_STATS_CLOCK();
+}
+
+
+/**
+ * @brief 结束统计操作
+ *        计数累加到当前线程的全局计数和模型计数
+ *
+ * @param scope 统计范围
+ * @param bytesIn 读取的数据大小
+ * @param bytesOut 输出的数据大小
+ */
+void reflectStatsEnd(ReflectStatsScope *scope, size_t bytesIn, size_t bytesOut)
+{
+    ReflectStatsShard *shard = scope->shard;
+    REFLECT_ASSERT(shard, return);
+    ReflectStatsCounter counter = {
+        1,
+        bytesIn,
+        bytesOut,
+        REFLECT_STATS_LOAD(&shard->stats.allocs) - scope->allocs,
+        REFLECT_STATS_LOAD(&shard->stats.frees) - scope->frees,
+        REFLECT_STATS_LOAD(&shard->stats.allocBytes) - scope->allocBytes,
+        REFLECT_STATS_CLOCK() - scope->start,
+        scope->maxDepth
+    };
+    shard->scope = scope->parent;
+    reflectStatsAdd(&shard->stats.ops[scope->op], &counter);
+
+    ReflectStatsEntry *entry = reflectStatsTableFind(&shard->models, scope->model);
+    if (!entry)
+    {
+        /* 扩容时快照可能正在读取，新模型的插入需要加锁 */
+        REFLECT_LOCK();
+        entry = reflectStatsTableGet(&shard->models, scope->model);
+        REFLECT_UNLOCK();
+    }
+    if (entry)
+    {
+        reflectStatsAdd(&entry->ops[scope->op], &counter);
+    }
+}
+
+
+/**
+ * @brief 进入下一层遍历
+ */
+void reflectStatsEnter(void)
+{
+    ReflectStatsShard *shard = reflectStatsCurrent;
+    if (shard && shard->scope)
+    {
+        size_t depth = ++shard->depth - shard->scope->depth;
+        if (depth > shard->scope->maxDepth)
+        {
+            shard->scope->maxDepth = depth;
+        }
+    }
+}
+
+
+/**
+ * @brief 退出当前层遍历
+ */
+void reflectStatsLeave(void)
+{
+    ReflectStatsShard *shard = reflectStatsCurrent;
+    if (shard && shard->scope)
+    {
+        shard->depth--;
+    }
+}
+
+
+/**
+ * @brief 记录遍历深度
+ *        用于自身记录嵌套深度的遍历
+ *
+ * @param depth 相对操作开始的深度
+ */
+void reflectStatsDepth(size_t depth)
+{
+    ReflectStatsShard *shard = reflectStatsCurrent;
+    if (shard && shard->scope && depth > shard->scope->maxDepth)
+    {
+        shard->scope->maxDepth = depth;
+    }
+}
+
+
+/**
+ * @brief 默认的统计计时函数
+ *
+ * @return uint64_t 单调递增的时间(ns)
+ */
+uint64_t reflectStatsClock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief 获取全局统计快照
+ *        合并所有线程的统计分片，未使能 REFLECT_STATS_ENABLE 时全部为0
+ *
+ * @param stats 统计快照
+ */
+void reflectStatsSnapshot(ReflectStats *stats)
+{
+    memset(stats, 0, sizeof(ReflectStats));
+    REFLECT_LOCK();
+    for (ReflectStatsShard *shard = reflectStatsShards; shard; shard = shard->next)
+    {
+        for (int i = 0; i < REFLECT_STATS_OP_COUNT; i++)
+        {
+            reflectStatsAdd(&stats->ops[i], &shard->stats.ops[i]);
+        }
+        stats->allocs += REFLECT_STATS_LOAD(&shard->stats.allocs);
+        stats->frees += REFLECT_STATS_LOAD(&shard->stats.frees);
+        stats->allocBytes += REFLECT_STATS_LOAD(&shard->stats.allocBytes);
+    }
+    REFLECT_UNLOCK();
+}
+
+
+/**
+ * @brief 获取模型统计快照
+ *
+ * @param model Reflection 模型
+ * @param ops 模型的各操作计数，REFLECT_STATS_OP_COUNT 个
+ * @return int 0 成功 -1 模型没有统计数据
+ */
+int reflectStatsModelSnapshot(Reflection *model, ReflectStatsCounter *ops)
+{
+    int result = -1;
+    memset(ops, 0, sizeof(ReflectStatsCounter) * REFLECT_STATS_OP_COUNT);
+    REFLECT_LOCK();
+    for (ReflectStatsShard *shard = reflectStatsShards; shard; shard = shard->next)
+    {
+        ReflectStatsEntry *entry = reflectStatsTableFind(&shard->models, model);
+        if (entry)
+        {
+            for (int i = 0; i < REFLECT_STATS_OP_COUNT; i++)
+            {
+                reflectStatsAdd(&ops[i], &entry->ops[i]);
+            }
+            result = 0;
+        }
+    }
+    REFLECT_UNLOCK();
+    return result;
+}
+
+
+/**
+ * @brief 遍历所有模型的统计快照
+ *
+ * @param visitor 遍历函数
+ * @param context 用户上下文
+ * @return int 0 成功 -1 内存不足
+ */
+int reflectStatsForEachModel(ReflectStatsVisitor visitor, void *context)
+{
+    ReflectStatsTable merged = {0};
+    int result = 0;
+    REFLECT_LOCK();
+    for (ReflectStatsShard *shard = reflectStatsShards; shard && result == 0; shard = shard->next)
+    {
+        for (size_t i = 0; i < shard->models.capacity; i++)
+        {
+            ReflectStatsEntry *src = &shard->models.entries[i];
+            if (!src->model)
+            {
+                continue;
+            }
+            ReflectStatsEntry *dest = reflectStatsTableGet(&merged, src->model);
+            if (!dest)
+            {
+                result = -1;
+                break;
+            }
+            for (int j = 0; j < REFLECT_STATS_OP_COUNT; j++)
+            {
+                reflectStatsAdd(&dest->ops[j], &src->ops[j]);
+            }
+        }
+    }
+    REFLECT_UNLOCK();
+    /* 遍历函数在锁外调用，可以在其中使用反射接口 */
+    for (size_t i = 0; i < merged.capacity && result == 0; i++)
+    {
+        if (merged.entries[i].model)
+        {
+            visitor(merged.entries[i].model, merged.entries[i].ops, context);
+        }
+    }
+    if (merged.entries)
+    {
+        REFLECT_FREE(merged.entries);
+    }
+    return result;
+}
+
+
+/**
+ * @brief 清零所有统计
+ *        与其他线程正在进行的操作同时清零时，这些操作的计数可能不准确
+ */
+void reflectStatsReset(void)
+{
+    REFLECT_LOCK();
+    for (ReflectStatsShard *shard = reflectStatsShards; shard; shard = shard->next)
+    {
+        reflectStatsClear(shard->stats.ops, REFLECT_STATS_OP_COUNT);
+        REFLECT_STATS_STORE(&shard->stats.allocs, 0);
+        REFLECT_STATS_STORE(&shard->stats.frees, 0);
+        REFLECT_STATS_STORE(&shard->stats.allocBytes, 0);
+        if (shard->models.entries)
+        {
+            for (size_t i = 0; i < shard->models.capacity; i++)
+            {
+                reflectStatsClear(shard->models.entries[i].ops, REFLECT_STATS_OP_COUNT);
+            }
+        }
+    }
+    REFLECT_UNLOCK();
+}
+#else
+void *reflectStatsMalloc(size_t size)
+{
+    return reflectMalloc(size);
+}
+
+
+void reflectStatsFree(void *ptr)
+{
+    reflectFree(ptr);
+}
+
+
+void reflectStatsBegin(ReflectStatsScope *scope, Reflection *model, ReflectStatsOp op)
+{
+    (void)scope;
+    (void)model;
+    (void)op;
+}
+
+
+void reflectStatsEnd(ReflectStatsScope *scope, size_t bytesIn, size_t bytesOut)
+{
+    (void)scope;
+    (void)bytesIn;
+    (void)bytesOut;
+}
+
+
+void reflectStatsEnter(void)
+{
+}
+
+
+void reflectStatsLeave(void)
+{
+}
+
+
+void reflectStatsDepth(size_t depth)
+{
+    (void)depth;
+}
+
+
+uint64_t reflectStatsClock(void)
+{
+    return 0;
+}
+
+
+void reflectStatsSnapshot(ReflectStats *stats)
+{
+    memset(stats, 0, sizeof(ReflectStats));
+}
+
+
+int reflectStatsModelSnapshot(Reflection *model, ReflectStatsCounter *ops)
+{
+    (void)model;
+    memset(ops, 0, sizeof(ReflectStatsCounter) * REFLECT_STATS_OP_COUNT);
+    return -1;
+}
+
+
+int reflectStatsForEachModel(ReflectStatsVisitor visitor, void *context)
+{
+    (void)visitor;
+    (void)context;
+    return 0;
+}
+
+
+void reflectStatsReset(void)
+{
+}
+#endif
+
+
+/**
+ * @brief 获取操作名称
+ *        用于导出统计数据
+ *
+ * @param op 操作
+ * @return const char* 操作名称
+ */
+const char *reflectStatsOpName(ReflectStatsOp op)
+{
+    return (unsigned)op < REFLECT_STATS_OP_COUNT ? reflectStatsOpNames[op] : "unknown";
+}
@@ -0,0 +1,223 @@
+/**
+ * @file reflect_stats.h
+ * @author agent
+ * @brief reflection runtime statistics
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#ifndef __REFLECT_STATS_H__
+#define __REFLECT_STATS_H__
+
+#include "reflection.h"
+
+/**
+ * @defgroup REFLECT_STATS reflect_stats
+ * @brief reflection runtime statistics
+ * @addtogroup REFLECT_STATS
+ * @{
+ */
+
+/**
+ * @brief 统计的操作
+ *
+ */
+typedef enum
+{
+    REFLECT_STATS_OP_SERIALIZE = 0,             /**< 序列化(cSerialize 系列，流式，紧凑和增量格式) */
+    REFLECT_STATS_OP_DESERIALIZE,               /**< 反序列化(cDeserialize 系列，流式，紧凑格式和应用增量)，
+                                                     流式反序列化器每次输入数据计为一次调用 */
+    REFLECT_STATS_OP_FREE,                      /**< 对象释放(reflectFreeObjEx，reflectFreeObjOpt，cBatchFree) */
+    REFLECT_STATS_OP_JSON_ENCODE,               /**< JSON 编码 */
+    REFLECT_STATS_OP_JSON_DECODE,               /**< JSON 解码 */
+    REFLECT_STATS_OP_COUNT,
+} ReflectStatsOp;
+
+/**
+ * @brief 操作计数
+ *
+ */
+typedef struct
+{
+    uint64_t calls;                             /**< 调用次数 */
+    uint64_t bytesIn;                           /**< 读取的数据大小 */
+    uint64_t bytesOut;                          /**< 输出的数据大小 */
+    uint64_t allocs;                            /**< 内存分配次数 */
+    uint64_t frees;                             /**< 内存释放次数 */
+    uint64_t allocBytes;                        /**< 内存分配大小 */
+    uint64_t timeNs;                            /**< 耗时(ns) */
+    uint64_t maxDepth;                          /**< 最大遍历深度 */
+} ReflectStatsCounter;
+
+/**
+ * @brief 全局统计
+ *
+ */
+typedef struct
+{
+    ReflectStatsCounter ops[REFLECT_STATS_OP_COUNT]; /**< 各操作计数 */
+    uint64_t allocs;                            /**< 通过 REFLECT_MALLOC 的内存分配次数 */
+    uint64_t frees;                             /**< 通过 REFLECT_FREE 的内存释放次数 */
+    uint64_t allocBytes;                        /**< 通过 REFLECT_MALLOC 的内存分配大小 */
+} ReflectStats;
+
+/**
+ * @brief 模型统计遍历函数
+ *
+ * @param model Reflection 模型
+ * @param ops 该模型的各操作计数，REFLECT_STATS_OP_COUNT 个
+ * @param context 用户上下文
+ */
+typedef void (*ReflectStatsVisitor)(Reflection *model, const ReflectStatsCounter *ops, void *context);
+
+/**
+ * @brief 操作统计范围
+ *        记录操作开始时的时间，内存分配计数和遍历深度
+ *
+ */
+typedef struct reflect_stats_scope
+{
+    struct reflect_stats_shard *shard;          /**< 所属线程的统计分片 */
+    struct reflect_stats_scope *parent;         /**< 外层操作 */
+    Reflection *model;                          /**< Reflection 模型 */
+    ReflectStatsOp op;                          /**< 操作 */
+    uint64_t start;                             /**< 开始时间 */
+    uint64_t allocs;                            /**< 开始时的分配次数 */
+    uint64_t frees;                             /**< 开始时的释放次数 */
+    uint64_t allocBytes;                        /**< 开始时的分配大小 */
+    size_t depth;                               /**< 开始时的遍历深度 */
+    size_t maxDepth;                            /**< 最大相对遍历深度 */
+} ReflectStatsScope;
+
+#if REFLECT_STATS_ENABLE == 1
+#define REFLECT_STATS_SCOPE(scope)                      ReflectStatsScope scope
+#define REFLECT_STATS_BEGIN(scope, model, op)           reflectStatsBegin(&(scope), model, op)
+#define REFLECT_STATS_END(scope, bytesIn, bytesOut)     reflectStatsEnd(&(scope), bytesIn, bytesOut)
+#define REFLECT_STATS_ENTER()                           reflectStatsEnter()
+#define REFLECT_STATS_LEAVE()                           reflectStatsLeave()
+#define REFLECT_STATS_DEPTH(depth)                      reflectStatsDepth(depth)
+
+#if !defined(REFLECT_STATS_IMPL) && !defined(REFLECT_ALLOC_IMPL)
+#undef REFLECT_MALLOC
+#undef REFLECT_FREE
+#define REFLECT_MALLOC          reflectStatsMalloc
+#define REFLECT_FREE            reflectStatsFree
+#endif
+#else
+#define REFLECT_STATS_SCOPE(scope)
+#define REFLECT_STATS_BEGIN(scope, model, op)
+#define REFLECT_STATS_END(scope, bytesIn, bytesOut)
+#define REFLECT_STATS_ENTER()
+#define REFLECT_STATS_LEAVE()
+#define REFLECT_STATS_DEPTH(depth)
+#endif
+
+/**
+ * @brief 统计内存分配
+ *        使能 REFLECT_STATS_ENABLE 时 REFLECT_MALLOC 替换为该函数
+ *
+ * @param size 大小
+ * @return void* 内存地址
+ */
+void *reflectStatsMalloc(size_t size);
+
+/**
+ * @brief 统计内存释放
+ *        使能 REFLECT_STATS_ENABLE 时 REFLECT_FREE 替换为该函数
+ *
+ * @param ptr 内存地址
+ */
+void reflectStatsFree(void *ptr);
+
+/**
+ * @brief 默认的统计计时函数
+ *
+ * @return uint64_t 单调递增的时间(ns)
+ */
+uint64_t reflectStatsClock(void);
+
+/**
+ * @brief 开始统计操作
+ *
+ * @param scope 统计范围，操作结束前有效
+ * @param model Reflection 模型
+ * @param op 操作
+ */
+void reflectStatsBegin(ReflectStatsScope *scope, Reflection *model, ReflectStatsOp op);
+
+/**
+ * @brief 结束统计操作
+ *        计数累加到当前线程的全局计数和模型计数
+ *
+ * @param scope 统计范围
+ * @param bytesIn 读取的数据大小
+ * @param bytesOut 输出的数据大小
+ */
+void reflectStatsEnd(ReflectStatsScope *scope, size_t bytesIn, size_t bytesOut);
+
+/**
+ * @brief 进入下一层遍历
+ */
+void reflectStatsEnter(void);
+
+/**
+ * @brief 退出当前层遍历
+ */
+void reflectStatsLeave(void);
+
+/**
+ * @brief 记录遍历深度
+ *        用于自身记录嵌套深度的遍历
+ *
+ * @param depth 相对操作开始的深度
+ */
+void reflectStatsDepth(size_t depth);
+
+/**
+ * @brief 获取全局统计快照
+ *        合并所有线程的统计分片，未使能 REFLECT_STATS_ENABLE 时全部为0
+ *
+ * @param stats 统计快照
+ */
+void reflectStatsSnapshot(ReflectStats *stats);
+
+/**
+ * @brief 获取模型统计快照
+ *
+ * @param model Reflection 模型
+ * @param ops 模型的各操作计数，REFLECT_STATS_OP_COUNT 个
+ * @return int 0 成功 -1 模型没有统计数据
+ */
+int reflectStatsModelSnapshot(Reflection *model, ReflectStatsCounter *ops);
+
+/**
+ * @brief 遍历所有模型的统计快照
+ *
+ * @param visitor 遍历函数
+ * @param context 用户上下文
+ * @return int 0 成功 -1 内存不足
+ */
+int reflectStatsForEachModel(ReflectStatsVisitor visitor, void *context);
+
+/**
+ * @brief 清零所有统计
+ *        与其他线程正在进行的操作同时清零时，这些操作的计数可能不准确
+ */
+void reflectStatsReset(void);
+
+/**
+ * @brief 获取操作名称
+ *        用于导出统计数据
+ *
+ * @param op 操作
+ * @return const char* 操作名称
+ */
+const char *reflectStatsOpName(ReflectStatsOp op);
+
+/**
+ * @}
+ */
+
+#endif
@@ -11,6 +11,7 @@
 #include "reflection.h"
 #include "string.h"
 #include "obj_list.h"
+#include "obj_map.h"
 
 /**
  * @brief 基本类型 Reflection 模型
@@ -44,12 +45,13 @@ Reflection reflectBasicTypeModel[] =
  * @brief 新字符串(字符串复制)
  * 
  * @param str 原字符串
- * @return char* 复制得到的新字符串
+ * @return char* 复制得到的新字符串，内存不足返回NULL
  */
 char *reflectNewString(char *str)
 {
     int len = strlen(str);
     char *dest = REFLECT_MALLOC(len + 1);
+    REFLECT_ASSERT(dest, return NULL);
     strcpy(dest, str);
     return dest;
 }
@@ -71,41 +73,588 @@ size_t reflectGetObjSize(Reflection *model)
 }
 
 
+#define REFLECT_FNV_OFFSET      0xcbf29ce484222325ULL
+#define REFLECT_FNV_PRIME       0x100000001b3ULL
+
 /**
- * @brief 释放对象内存
+ * @brief FNV-1a 哈希
  * 
- * @param obj 对象
+ * @param hash 当前哈希值
+ * @param data 数据
+ * @param size 数据大小
+ * @return uint64_t 哈希值
+ */
+static uint64_t reflectFnv(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ p[i]) * REFLECT_FNV_PRIME;
+    }
+    return hash;
+}
+
+
+/**
+ * @brief 字段名哈希
+ * 
+ * @param name 字段名
+ * @return size_t 哈希值
+ */
+static size_t reflectNameHash(const char *name, size_t len)
+{
+    return (size_t)reflectFnv(REFLECT_FNV_OFFSET, name, len);
+}
+
+
+/**
+ * @brief 执行计划缓存
+ *
+ */
+static ObjMap reflectPlanMap = {0};
+
+#if REFLECT_PLAN_PUBLISH_SIZE > 0 && defined(REFLECT_LOAD_ACQUIRE) && defined(REFLECT_STORE_RELEASE)
+#define REFLECT_PLAN_PUBLISH        1
+#if (REFLECT_PLAN_PUBLISH_SIZE & (REFLECT_PLAN_PUBLISH_SIZE - 1)) != 0
+#error "REFLECT_PLAN_PUBLISH_SIZE must be a power of 2"
+#endif
+
+/**
+ * @brief 已发布的执行计划
+ *        只增不删，写入在 REFLECT_LOCK 内进行，先写入计划再以 release 写入模型，
+ *        读取时以 acquire 读取模型，模型匹配时计划已完成
+ *
+ */
+typedef struct
+{
+    Reflection *model;                          /**< Reflection 模型，NULL表示空位 */
+    ReflectPlan *plan;                          /**< 执行计划 */
+} ReflectPlanSlot;
+
+static ReflectPlanSlot reflectPlanPublished[REFLECT_PLAN_PUBLISH_SIZE];
+
+
+/**
+ * @brief 模型地址哈希
+ *
  * @param model Reflection 模型
- * @param isPointer 是否为指针类型
+ * @return size_t 哈希值
  */
-void reflectFreeObjEx(void *obj, Reflection *model, char isPointer)
+static size_t reflectPlanSlotHash(Reflection *model)
+{
+    size_t h = (size_t)model >> 3;
+    h ^= h >> 15;
+    h *= (size_t)0x2c1b3c6dUL;
+    h ^= h >> 12;
+    return h;
+}
+
+
+/**
+ * @brief 无锁查找已发布的执行计划
+ *
+ * @param model Reflection 模型
+ * @return ReflectPlan* 执行计划，未发布返回NULL
+ */
+static ReflectPlan *reflectPlanLookup(Reflection *model)
+{
+    size_t mask = REFLECT_PLAN_PUBLISH_SIZE - 1;
+    size_t index = reflectPlanSlotHash(model) & mask;
+    for (size_t i = 0; i < REFLECT_PLAN_PUBLISH_SIZE; i++)
+    {
+        ReflectPlanSlot *slot = &reflectPlanPublished[(index + i) & mask];
+        Reflection *key = REFLECT_LOAD_ACQUIRE(&slot->model);
+        if (key == model)
+        {
+            return slot->plan;
+        }
+        if (!key)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief 发布编译完成的执行计划
+ *        在 REFLECT_LOCK 内调用，查找表已满时不发布，之后通过加锁查找获取
+ *
+ * @param plan 执行计划
+ */
+static void reflectPlanPublish(ReflectPlan *plan)
+{
+    size_t mask = REFLECT_PLAN_PUBLISH_SIZE - 1;
+    size_t index = reflectPlanSlotHash(plan->model) & mask;
+    for (size_t i = 0; i < REFLECT_PLAN_PUBLISH_SIZE; i++)
+    {
+        ReflectPlanSlot *slot = &reflectPlanPublished[(index + i) & mask];
+        if (slot->model == plan->model)
+        {
+            return;
+        }
+        if (!slot->model)
+        {
+            slot->plan = plan;
+            REFLECT_STORE_RELEASE(&slot->model, plan->model);
+            return;
+        }
+    }
+}
+#endif
+
+
+/**
+ * @brief 添加数据区间，与上一个区间相邻时合并
+ * 
+ * @param ranges 区间，为NULL时只计数
+ * @param count 区间数量
+ * @param end 上一个区间的结束偏移
+ * @param offset 区间偏移
+ * @param size 区间大小
+ */
+static void reflectPlanAddRange(ReflectPlanRange *ranges, size_t *count, size_t *end,
+                                size_t offset, size_t size)
+{
+    if (*count > 0 && *end == offset)
+    {
+        if (ranges)
+        {
+            ranges[*count - 1].size += size;
+        }
+    }
+    else
+    {
+        if (ranges)
+        {
+            ranges[*count].offset = offset;
+            ranges[*count].size = size;
+        }
+        (*count)++;
+    }
+    *end = offset + size;
+}
+
+
+/**
+ * @brief 收集对象中基本类型数据所在的区间
+ *        包括内嵌结构体和数组中的基本类型数据，不包括指针，字符串，链表和动态数组字段以及对齐填充
+ * 
+ * @param plan 执行计划，内嵌结构体和数组的子计划需要已经编译完成
+ * @param ranges 区间，为NULL时只计数
+ * @return size_t 区间数量
+ */
+static size_t reflectPlanCollectRanges(ReflectPlan *plan, ReflectPlanRange *ranges)
+{
+    size_t count = 0;
+    size_t end = 0;
+    for (Reflection *p = plan->model; p->type != REFLECT_TYPE_OBJ; p++)
+    {
+        if (p->isPointer || p->type == REFLECT_TYPE_STRING
+            || p->type == REFLECT_TYPE_LIST || p->type == REFLECT_TYPE_VECTOR)
+        {
+            continue;
+        }
+        if (p->type == REFLECT_TYPE_STRUCT || p->type == REFLECT_TYPE_ARRAY)
+        {
+            ReflectPlan *child = objMapGet(&reflectPlanMap, p->model);
+            size_t items = p->type == REFLECT_TYPE_ARRAY ? p->size : 1;
+            for (size_t i = 0; i < items; i++)
+            {
+                for (size_t j = 0; j < child->rangeCount; j++)
+                {
+                    reflectPlanAddRange(ranges, &count, &end,
+                        p->offset + child->size * i + child->ranges[j].offset,
+                        child->ranges[j].size);
+                }
+            }
+        }
+        else
+        {
+            reflectPlanAddRange(ranges, &count, &end, p->offset, p->size);
+        }
+    }
+    return count;
+}
+
+
+/**
+ * @brief 编译 Reflection 模型及其未编译的子模型(无锁)
+ *        新编译的计划记录在 pending 中，整个模型图编译完成后由 reflectPlanResolve
+ *        确定 isPlain 和数据区间，避免互相引用的模型取得未完成的计划
+ *
+ * @param model Reflection 模型
+ * @param pending 新编译的计划
+ * @return ReflectPlan* 执行计划，内存不足返回NULL
+ */
+static ReflectPlan *reflectCompilePlan(Reflection *model, ObjMap *pending)
 {
+    ReflectPlan *plan = objMapGet(&reflectPlanMap, model);
+    if (plan)
+    {
+        return plan;
+    }
+
     Reflection *p = model;
+    size_t count = 0;
+    size_t keySize = 0;
     while (p->type != REFLECT_TYPE_OBJ)
     {
+        if (p->name)
+        {
+            keySize += strlen(p->name) + 4;
+        }
+        p++;
+        count++;
+    }
+
+    size_t indexSize = 1;
+    while (indexSize < count * 2)
+    {
+        indexSize <<= 1;
+    }
+    plan = REFLECT_MALLOC(sizeof(ReflectPlan) + sizeof(ReflectPlanField) * count * 2
+                          + sizeof(Reflection *) * indexSize + keySize);
+    REFLECT_ASSERT(plan, return NULL);
+    plan->model = model;
+    plan->size = p->size;
+    plan->alignedSize = REFLECT_ALIGN(p->size);
+    plan->fieldCount = 0;
+    plan->fields = (ReflectPlanField *)(plan + 1);
+    plan->memberCount = count;
+    plan->members = plan->fields + count;
+    plan->isPlain = 0;
+    plan->nameIndex = (Reflection **)(plan->members + count);
+    plan->nameMask = indexSize - 1;
+    plan->rangeCount = 0;
+    plan->ranges = NULL;
+    memset(plan->nameIndex, 0, sizeof(Reflection *) * indexSize);
+    for (p = model; p->type != REFLECT_TYPE_OBJ; p++)
+    {
+        if (p->name)
+        {
+            size_t j = reflectNameHash(p->name, strlen(p->name)) & plan->nameMask;
+            while (plan->nameIndex[j])
+            {
+                j = (j + 1) & plan->nameMask;
+            }
+            plan->nameIndex[j] = p;
+        }
+    }
+    /* 先加入缓存再编译子模型，自引用的模型可以直接取得当前计划 */
+    if (objMapPut(&reflectPlanMap, model, plan) != 0)
+    {
+        REFLECT_FREE(plan);
+        return NULL;
+    }
+    if (objMapPut(pending, plan, plan) != 0)
+    {
+        objMapRemove(&reflectPlanMap, model);
+        REFLECT_FREE(plan);
+        return NULL;
+    }
+
+    char *keys = (char *)(plan->nameIndex + indexSize);
+    for (p = model; p->type != REFLECT_TYPE_OBJ; p++)
+    {
+        ReflectPlan *child = NULL;
+        if (p->model)
+        {
+            child = reflectCompilePlan(p->model, pending);
+            REFLECT_ASSERT(child, return NULL);
+        }
+        ReflectPlanField *member = &plan->members[p - model];
+        member->field = p;
+        member->isPointer = p->isPointer;
+        member->type = p->type;
+        member->offset = p->offset;
+        member->count = p->type == REFLECT_TYPE_ARRAY ? p->size : 1;
+        member->countOffset = p->type == REFLECT_TYPE_VECTOR ? p->size : 0;
+        member->plan = child;
+        member->key = NULL;
+        member->keyLen = 0;
+        if (p->name)
+        {
+            /* 逐字段编码的格式直接写入预先生成的键文本，第一个字段跳过逗号 */
+            size_t len = strlen(p->name);
+            keys[0] = ',';
+            keys[1] = '"';
+            memcpy(keys + 2, p->name, len);
+            keys[len + 2] = '"';
+            keys[len + 3] = ':';
+            member->key = keys;
+            member->keyLen = len + 4;
+            keys += len + 4;
+        }
+        /* 内嵌结构体和数组先全部记录，子计划是否含指针在 reflectPlanResolve 中确定 */
+        if (p->isPointer
+            || p->type == REFLECT_TYPE_STRING
+            || p->type == REFLECT_TYPE_LIST
+            || p->type == REFLECT_TYPE_VECTOR
+            || p->type == REFLECT_TYPE_STRUCT
+            || p->type == REFLECT_TYPE_ARRAY)
+        {
+            plan->fields[plan->fieldCount++] = *member;
+        }
+    }
+    return plan;
+}
+
+
+/**
+ * @brief 完成新编译的计划
+ *        去掉不含指针的内嵌结构体和数组字段，确定 isPlain 并收集数据区间，
+ *        内嵌结构体不会构成环，子计划总是先于当前计划完成
+ *
+ * @param plan 执行计划
+ * @param pending 新编译的计划，完成的计划值置为NULL
+ * @return int 0 成功 -1 内存不足
+ */
+static int reflectPlanResolve(ReflectPlan *plan, ObjMap *pending)
+{
+    ObjMapEntry *entry = objMapFind(pending, plan);
+    if (!entry || !entry->value)
+    {
+        return 0;
+    }
+    entry->value = NULL;
+
+    size_t count = 0;
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *field = &plan->fields[i];
+        if (!field->isPointer
+            && (field->type == REFLECT_TYPE_STRUCT || field->type == REFLECT_TYPE_ARRAY))
+        {
+            if (reflectPlanResolve(field->plan, pending) != 0)
+            {
+                return -1;
+            }
+            if (field->plan->isPlain)
+            {
+                continue;
+            }
+        }
+        plan->fields[count++] = *field;
+    }
+    plan->fieldCount = count;
+    plan->isPlain = count == 0;
+
+    size_t rangeCount = reflectPlanCollectRanges(plan, NULL);
+    if (rangeCount > 0)
+    {
+        plan->ranges = REFLECT_MALLOC(sizeof(ReflectPlanRange) * rangeCount);
+        REFLECT_ASSERT(plan->ranges, return -1);
+        plan->rangeCount = reflectPlanCollectRanges(plan, plan->ranges);
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 编译 Reflection 模型
+ *        模型及其子模型的执行计划只编译一次，之后直接从缓存获取
+ *
+ * @param model Reflection 模型
+ * @return ReflectPlan* 执行计划，内存不足返回NULL
+ */
+ReflectPlan *reflectCompileModel(Reflection *model)
+{
+#if REFLECT_PLAN_PUBLISH == 1
+    /* 已编译的计划不加锁直接获取 */
+    ReflectPlan *published = reflectPlanLookup(model);
+    if (published)
+    {
+        return published;
+    }
+#endif
+    /* 执行计划全局缓存，不使用线程绑定的分配器 */
+    ReflectAllocator *allocator = reflectSetAllocator(NULL);
+    ObjMap pending = {0};
+    REFLECT_LOCK();
+    ReflectPlan *plan = reflectCompilePlan(model, &pending);
+    for (size_t i = 0; plan && i < pending.capacity; i++)
+    {
+        if (pending.entries[i].key
+            && reflectPlanResolve(pending.entries[i].key, &pending) != 0)
+        {
+            plan = NULL;
+        }
+    }
+    if (!plan)
+    {
+        /* 编译失败时丢弃本次编译的所有计划，不在缓存中留下未完成的计划 */
+        for (size_t i = 0; i < pending.capacity; i++)
+        {
+            ReflectPlan *discard = pending.entries[i].key;
+            if (discard)
+            {
+                objMapRemove(&reflectPlanMap, discard->model);
+                if (discard->ranges)
+                {
+                    REFLECT_FREE(discard->ranges);
+                }
+                REFLECT_FREE(discard);
+            }
+        }
+    }
+#if REFLECT_PLAN_PUBLISH == 1
+    else
+    {
+        /* 整个模型图都已完成后再发布，无锁读取不会取得未完成的计划 */
+        for (size_t i = 0; i < pending.capacity; i++)
+        {
+            if (pending.entries[i].key)
+            {
+                reflectPlanPublish(pending.entries[i].key);
+            }
+        }
+        reflectPlanPublish(plan);
+    }
+#endif
+    REFLECT_UNLOCK();
+    objMapClear(&pending);
+    reflectSetAllocator(allocator);
+    return plan;
+}
+
+
+/**
+ * @brief 计算模型指纹
+ * 
+ * @param model Reflection 模型
+ * @param visited 已计算的模型，值为模型序号
+ * @param hash 当前哈希值
+ * @return uint64_t 哈希值
+ */
+static uint64_t reflectFingerprint(Reflection *model, ObjMap *visited, uint64_t hash)
+{
+    ObjMapEntry *entry = objMapFind(visited, model);
+    if (entry)
+    {
+        /* 递归模型只记录引用的模型序号 */
+        uint64_t index = (uint64_t)(size_t)entry->value;
+        return reflectFnv(hash, &index, sizeof(index));
+    }
+    objMapPut(visited, model, (void *)visited->size);
+
+    Reflection *p = model;
+    while (1)
+    {
+        uint64_t values[4] = {p->isPointer, p->type, p->size, (uint64_t)(int64_t)p->offset};
+        hash = reflectFnv(hash, values, sizeof(values));
+        if (p->name)
+        {
+            hash = reflectFnv(hash, p->name, strlen(p->name) + 1);
+        }
+        if (p->type == REFLECT_TYPE_OBJ)
+        {
+            break;
+        }
+        if (p->model)
+        {
+            hash = reflectFingerprint(p->model, visited, hash);
+        }
+        p++;
+    }
+    return hash;
+}
+
+
+/**
+ * @brief 获取模型指纹
+ *        由模型及其子模型的字段类型，大小，偏移和名称计算得到，用于校验数据与模型是否匹配
+ * 
+ * @param model Reflection 模型
+ * @return uint64_t 模型指纹
+ */
+uint64_t reflectGetModelFingerprint(Reflection *model)
+{
+    ObjMap visited = {0};
+    uint64_t hash = reflectFingerprint(model, &visited, REFLECT_FNV_OFFSET);
+    objMapClear(&visited);
+    return hash;
+}
+
+
+/**
+ * @brief 对象释放上下文
+ *
+ */
+typedef struct
+{
+    ObjMap *freed;                              /**< 已释放的对象，为NULL时不记录 */
+    char keepStrings;                           /**< 不释放字符串 */
+} ReflectFreeContext;
+
+static void reflectFreeGraphObj(void *obj, ReflectPlan *plan, char isPointer, ReflectFreeContext *ctx);
+
+/**
+ * @brief 释放对象引用的子对象
+ *        记录已释放的对象时，被多处引用的对象只释放一次
+ *
+ * @param obj 子对象
+ * @param plan 执行计划
+ * @param ctx 释放上下文，为NULL时按默认方式释放
+ */
+static void reflectFreeRef(void *obj, ReflectPlan *plan, ReflectFreeContext *ctx)
+{
+    if (ctx && ctx->freed && obj)
+    {
+        if (objMapFind(ctx->freed, obj) || objMapPut(ctx->freed, obj, obj) != 0)
+        {
+            /* 已经释放，或者无法记录时宁可泄漏也不重复释放 */
+            return;
+        }
+    }
+    REFLECT_STATS_ENTER();
+    reflectFreeGraphObj(obj, plan, 1, ctx);
+    REFLECT_STATS_LEAVE();
+}
+
+
+/**
+ * @brief 按执行计划释放对象内存
+ *
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param isPointer 是否为指针类型
+ * @param ctx 释放上下文，为NULL时按默认方式释放
+ */
+static void reflectFreeGraphObj(void *obj, ReflectPlan *plan, char isPointer, ReflectFreeContext *ctx)
+{
+    REFLECT_ASSERT(obj, return);
+
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
         if (p->isPointer)
         {
-            reflectFreeObjEx((void *)(*(size_t *)((size_t)obj + p->offset)), p->model, 1);
+            reflectFreeRef(*(void **)addr, p->plan, ctx);
         }
         else if (p->type == REFLECT_TYPE_STRING)
         {
-            REFLECT_FREE((char *)(*(size_t *)((size_t)obj + p->offset)));
+            if (!ctx || !ctx->keepStrings)
+            {
+                REFLECT_FREE(*(char **)addr);
+            }
         }
         else if (p->type == REFLECT_TYPE_ARRAY)
         {
-            size_t itemSize = reflectGetObjSize(p->model);
-            for (size_t i = 0; i < p->size; i++)
+            for (size_t j = 0; j < p->count; j++)
             {
-                reflectFreeObjEx((void *)((size_t)obj + p->offset + itemSize * i), p->model, 0);
+                reflectFreeGraphObj((void *)((size_t)addr + p->plan->size * j), p->plan, 0, ctx);
             }
         }
         else if (p->type == REFLECT_TYPE_STRUCT)
         {
-            reflectFreeObjEx((void *)((size_t)obj + p->offset), p->model, 0);
+            reflectFreeGraphObj(addr, p->plan, 0, ctx);
         }
         else if (p->type == REFLECT_TYPE_LIST)
         {
-            ObjList *list = (ObjList *)*(size_t *)((size_t)obj + p->offset);
+            ObjList *list = *(ObjList **)addr;
             ObjList *item;
             while (list)
             {
@@ -113,15 +662,930 @@ void reflectFreeObjEx(void *obj, Reflection *model, char isPointer)
                 list = list->next;
                 if (item->obj)
                 {
-                    reflectFreeObjEx(item->obj, p->model, 1);
+                    reflectFreeRef(item->obj, p->plan, ctx);
                 }
-                REFLECT_FREE(item);
+                objListNodeFree(item);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            if (items)
+            {
+                size_t count = *(size_t *)((size_t)obj + p->countOffset);
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    reflectFreeGraphObj(items + p->plan->size * j, p->plan, 0, ctx);
+                }
+                REFLECT_FREE(items);
             }
         }
-        p++;
     }
     if (isPointer)
     {
         REFLECT_FREE(obj);
     }
 }
+
+
+/**
+ * @brief 按执行计划释放对象内存
+ *
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param isPointer 是否为指针类型
+ */
+void reflectFreePlanObj(void *obj, ReflectPlan *plan, char isPointer)
+{
+    REFLECT_STATS_ENTER();
+    reflectFreeGraphObj(obj, plan, isPointer, NULL);
+    REFLECT_STATS_LEAVE();
+}
+
+
+/**
+ * @brief 释放对象内存
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param isPointer 是否为指针类型
+ */
+void reflectFreeObjEx(void *obj, Reflection *model, char isPointer)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_FREE);
+    reflectFreePlanObj(obj, plan, isPointer);
+    REFLECT_STATS_END(scope, 0, 0);
+}
+
+
+/**
+ * @brief 按选项释放对象内存
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param options 释放选项，REFLECT_FREE_SHARED，REFLECT_FREE_KEEP_STRINGS 的组合
+ */
+void reflectFreeObjOpt(void *obj, Reflection *model, int options)
+{
+    REFLECT_ASSERT(obj, return);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return);
+    REFLECT_STATS_SCOPE(scope);
+    REFLECT_STATS_BEGIN(scope, model, REFLECT_STATS_OP_FREE);
+    ObjMap freed = {0};
+    ReflectFreeContext ctx = {
+        (options & REFLECT_FREE_SHARED) ? &freed : NULL,
+        (options & REFLECT_FREE_KEEP_STRINGS) != 0
+    };
+    reflectFreeRef(obj, plan, &ctx);
+    objMapClear(&freed);
+    REFLECT_STATS_END(scope, 0, 0);
+}
+
+
+/**
+ * @brief 在执行计划的字段名索引中查找字段
+ * 
+ * @param plan 执行计划
+ * @param name 字段名，不需要以'\0'结束
+ * @param len 字段名长度
+ * @return Reflection* 字段模型，未找到返回NULL
+ */
+Reflection *reflectPlanFindField(ReflectPlan *plan, const char *name, size_t len)
+{
+    size_t i = reflectNameHash(name, len) & plan->nameMask;
+    while (plan->nameIndex[i])
+    {
+        if (strncmp(plan->nameIndex[i]->name, name, len) == 0
+            && plan->nameIndex[i]->name[len] == '\0')
+        {
+            return plan->nameIndex[i];
+        }
+        i = (i + 1) & plan->nameMask;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief 按字段名查找字段
+ *        通过执行计划中的字段名哈希索引查找，索引在模型编译时建立
+ * 
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @return Reflection* 字段模型，未找到返回NULL
+ */
+Reflection *reflectFindField(Reflection *model, const char *name)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    return reflectPlanFindField(plan, name, strlen(name));
+}
+
+
+/**
+ * @brief 获取基本类型字段的数据地址
+ *        指针类型字段返回指向的数据地址
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @param type 字段类型，返回查找到的字段类型
+ * @return void* 数据地址，字段不存在或者指针为NULL时返回NULL
+ */
+static void *reflectGetScalar(void *obj, Reflection *model, const char *name, ReflectionType *type)
+{
+    REFLECT_ASSERT(obj, return NULL);
+    Reflection *field = reflectFindField(model, name);
+    REFLECT_ASSERT(field, return NULL);
+    void *addr = (void *)((size_t)obj + field->offset);
+    *type = field->type;
+    return field->isPointer ? *(void **)addr : addr;
+}
+
+
+/**
+ * @brief 按字段名获取整数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 char，short，int 或 long
+ * @return long 字段值，字段不存在或类型不匹配时返回0
+ */
+long reflectGetInt(void *obj, Reflection *model, const char *name)
+{
+    ReflectionType type;
+    void *addr = reflectGetScalar(obj, model, name, &type);
+    REFLECT_ASSERT(addr, return 0);
+    switch (type)
+    {
+    case REFLECT_TYPE_CHAR:
+        return *(char *)addr;
+    case REFLECT_TYPE_SHORT:
+        return *(short *)addr;
+    case REFLECT_TYPE_INT:
+        return *(int *)addr;
+    case REFLECT_TYPE_LONG:
+        return *(long *)addr;
+    default:
+        return 0;
+    }
+}
+
+
+/**
+ * @brief 按字段名设置整数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 char，short，int 或 long
+ * @param value 字段值，按字段类型截断
+ * @return int 0 成功 -1 字段不存在或类型不匹配
+ */
+int reflectSetInt(void *obj, Reflection *model, const char *name, long value)
+{
+    ReflectionType type;
+    void *addr = reflectGetScalar(obj, model, name, &type);
+    REFLECT_ASSERT(addr, return -1);
+    switch (type)
+    {
+    case REFLECT_TYPE_CHAR:
+        *(char *)addr = (char)value;
+        return 0;
+    case REFLECT_TYPE_SHORT:
+        *(short *)addr = (short)value;
+        return 0;
+    case REFLECT_TYPE_INT:
+        *(int *)addr = (int)value;
+        return 0;
+    case REFLECT_TYPE_LONG:
+        *(long *)addr = value;
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+
+/**
+ * @brief 按字段名获取浮点数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 float 或 double
+ * @return double 字段值，字段不存在或类型不匹配时返回0
+ */
+double reflectGetDouble(void *obj, Reflection *model, const char *name)
+{
+    ReflectionType type;
+    void *addr = reflectGetScalar(obj, model, name, &type);
+    REFLECT_ASSERT(addr, return 0);
+    if (type == REFLECT_TYPE_FLOAT)
+    {
+        return *(float *)addr;
+    }
+    return type == REFLECT_TYPE_DOUBLE ? *(double *)addr : 0;
+}
+
+
+/**
+ * @brief 按字段名设置浮点数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 float 或 double
+ * @param value 字段值
+ * @return int 0 成功 -1 字段不存在或类型不匹配
+ */
+int reflectSetDouble(void *obj, Reflection *model, const char *name, double value)
+{
+    ReflectionType type;
+    void *addr = reflectGetScalar(obj, model, name, &type);
+    REFLECT_ASSERT(addr, return -1);
+    if (type == REFLECT_TYPE_FLOAT)
+    {
+        *(float *)addr = (float)value;
+        return 0;
+    }
+    else if (type == REFLECT_TYPE_DOUBLE)
+    {
+        *(double *)addr = value;
+        return 0;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief 按字段名获取字符串字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @return char* 字符串，字段不存在或类型不匹配时返回NULL
+ */
+char *reflectGetString(void *obj, Reflection *model, const char *name)
+{
+    REFLECT_ASSERT(obj, return NULL);
+    Reflection *field = reflectFindField(model, name);
+    if (!field || field->type != REFLECT_TYPE_STRING)
+    {
+        return NULL;
+    }
+    return *(char **)((size_t)obj + field->offset);
+}
+
+
+/**
+ * @brief 按字段名设置字符串字段
+ *        字符串被复制，原字符串被释放，与 reflectFreeObj 的内存管理一致
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @param value 字符串，可为NULL
+ * @return int 0 成功 -1 字段不存在，类型不匹配或内存不足
+ */
+int reflectSetString(void *obj, Reflection *model, const char *name, const char *value)
+{
+    REFLECT_ASSERT(obj, return -1);
+    Reflection *field = reflectFindField(model, name);
+    if (!field || field->type != REFLECT_TYPE_STRING)
+    {
+        return -1;
+    }
+    char **addr = (char **)((size_t)obj + field->offset);
+    char *str = NULL;
+    if (value)
+    {
+        str = reflectNewString((char *)value);
+        REFLECT_ASSERT(str, return -1);
+    }
+    if (*addr)
+    {
+        REFLECT_FREE(*addr);
+    }
+    *addr = str;
+    return 0;
+}
+
+
+/**
+ * @brief 编译字段路径
+ *        路径由'.'分隔的字段名组成，数组，链表和动态数组字段可以使用[n]指定元素，例如 "sub.sub[1].a"，
+ *        编译时解析字段名并合并连续的偏移，求值时只需要按步骤累加偏移和解引用
+ * 
+ * @param model Reflection 模型
+ * @param path 字段路径
+ * @return ReflectPath* 编译得到的路径，路径无效或内存不足返回NULL
+ * @note 使用 reflectFreePath 释放
+ */
+ReflectPath *reflectCompilePath(Reflection *model, const char *path)
+{
+    size_t count = 1;
+    for (const char *c = path; *c; c++)
+    {
+        count += *c == '.';
+    }
+    ReflectPath *result = REFLECT_MALLOC(sizeof(ReflectPath) + sizeof(ReflectPathStep) * count);
+    REFLECT_ASSERT(result, return NULL);
+    result->stepCount = 0;
+
+    size_t offset = 0;
+    const char *c = path;
+    while (1)
+    {
+        ReflectPlan *plan = model ? reflectCompileModel(model) : NULL;
+        size_t len = strcspn(c, ".[");
+        Reflection *field = plan && len ? reflectPlanFindField(plan, c, len) : NULL;
+        REFLECT_ASSERT(field, goto invalid);
+        size_t base = offset;
+        offset += field->offset;
+        model = field->model;
+        c += len;
+
+        unsigned char op = REFLECT_PATH_OP_NONE;
+        size_t index = 0;
+        if (*c == '[')
+        {
+            char *end;
+            index = strtoul(c + 1, &end, 10);
+            if (end == c + 1 || *end != ']')
+            {
+                goto invalid;
+            }
+            c = end + 1;
+            if (field->type == REFLECT_TYPE_ARRAY && !field->isPointer && index < field->size)
+            {
+                offset += reflectGetObjSize(field->model) * index;
+            }
+            else if (field->type == REFLECT_TYPE_LIST)
+            {
+                op = REFLECT_PATH_OP_LIST;
+            }
+            else if (field->type == REFLECT_TYPE_VECTOR)
+            {
+                op = REFLECT_PATH_OP_VECTOR;
+            }
+            else
+            {
+                goto invalid;
+            }
+        }
+        else if (field->type == REFLECT_TYPE_ARRAY || field->type == REFLECT_TYPE_LIST
+                 || field->type == REFLECT_TYPE_VECTOR)
+        {
+            /* 未指定元素时路径只能在数组，链表，动态数组字段本身结束 */
+            model = NULL;
+        }
+
+        if (*c == '.')
+        {
+            if (op == REFLECT_PATH_OP_NONE && field->isPointer)
+            {
+                op = REFLECT_PATH_OP_DEREF;
+            }
+            else if (op == REFLECT_PATH_OP_NONE && field->type != REFLECT_TYPE_STRUCT
+                     && field->type != REFLECT_TYPE_ARRAY)
+            {
+                goto invalid;
+            }
+            if (*++c == '\0')
+            {
+                goto invalid;
+            }
+        }
+        else if (*c != '\0')
+        {
+            goto invalid;
+        }
+
+        if (op != REFLECT_PATH_OP_NONE || *c == '\0')
+        {
+            ReflectPathStep *step = &result->steps[result->stepCount++];
+            step->offset = offset;
+            step->op = op;
+            step->index = index;
+            step->itemSize = op == REFLECT_PATH_OP_VECTOR ? reflectGetObjSize(field->model) : 0;
+            step->countOffset = op == REFLECT_PATH_OP_VECTOR ? base + field->size : 0;
+            offset = 0;
+        }
+        if (*c == '\0')
+        {
+            result->field = field;
+            return result;
+        }
+    }
+
+invalid:
+    REFLECT_FREE(result);
+    return NULL;
+}
+
+
+/**
+ * @brief 按编译的路径获取字段地址
+ * 
+ * @param path 编译得到的路径
+ * @param obj 对象
+ * @return void* 字段(或数组，链表元素)地址，路径中的指针为NULL或者链表，动态数组元素不存在时返回NULL
+ */
+void *reflectPathGet(ReflectPath *path, void *obj)
+{
+    size_t addr = (size_t)obj;
+    for (size_t i = 0; i < path->stepCount && addr; i++)
+    {
+        ReflectPathStep *step = &path->steps[i];
+        size_t base = addr;
+        addr += step->offset;
+        if (step->op == REFLECT_PATH_OP_DEREF)
+        {
+            addr = *(size_t *)addr;
+        }
+        else if (step->op == REFLECT_PATH_OP_LIST)
+        {
+            ObjList *list = *(ObjList **)addr;
+            for (size_t j = 0; j < step->index && list; j++)
+            {
+                list = list->next;
+            }
+            addr = list ? (size_t)list->obj : 0;
+        }
+        else if (step->op == REFLECT_PATH_OP_VECTOR)
+        {
+            addr = step->index < *(size_t *)(base + step->countOffset)
+                ? *(size_t *)addr + step->itemSize * step->index : 0;
+        }
+    }
+    return (void *)addr;
+}
+
+
+/**
+ * @brief 获取克隆对象附加数据(对象本身之后的数据)所需的内存大小
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ * @return size_t 内存大小
+ */
+static size_t reflectCloneSize(void *obj, ReflectPlan *plan)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        if (p->isPointer)
+        {
+            if (*(void **)addr)
+            {
+                size += p->plan->alignedSize + reflectCloneSize(*(void **)addr, p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            if (*(char **)addr)
+            {
+                size += REFLECT_ALIGN(strlen(*(char **)addr) + 1);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                size += reflectCloneSize((void *)((size_t)addr + p->plan->size * j), p->plan);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            size += reflectCloneSize(addr, p->plan);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            for (ObjList *list = *(ObjList **)addr; list; list = list->next)
+            {
+                size += sizeof(ObjList);
+                if (list->obj)
+                {
+                    size += p->plan->alignedSize + reflectCloneSize(list->obj, p->plan);
+                }
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            if (items)
+            {
+                size_t count = *(size_t *)((size_t)obj + p->countOffset);
+                size += REFLECT_ALIGN(p->plan->size * count);
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    size += reflectCloneSize(items + p->plan->size * j, p->plan);
+                }
+            }
+        }
+    }
+    return size;
+}
+
+
+/**
+ * @brief 克隆对象
+ *        对象本身已经复制到 dest，依次从内存块中分配字段指向的数据并修正指针
+ * 
+ * @param dest 目标对象
+ * @param src 源对象
+ * @param plan 执行计划
+ * @param cursor 内存块中下一个可用的地址
+ * @return char* 克隆后内存块中下一个可用的地址
+ */
+static char *reflectCloneFields(void *dest, void *src, ReflectPlan *plan, char *cursor)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *srcAddr = (void *)((size_t)src + p->offset);
+        void *destAddr = (void *)((size_t)dest + p->offset);
+        if (p->isPointer)
+        {
+            void *child = *(void **)srcAddr;
+            if (child)
+            {
+                *(void **)destAddr = cursor;
+                memcpy(cursor, child, p->plan->size);
+                cursor = reflectCloneFields(cursor, child, p->plan, cursor + p->plan->alignedSize);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            char *str = *(char **)srcAddr;
+            if (str)
+            {
+                size_t len = strlen(str) + 1;
+                *(char **)destAddr = memcpy(cursor, str, len);
+                cursor += REFLECT_ALIGN(len);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                cursor = reflectCloneFields((void *)((size_t)destAddr + p->plan->size * j),
+                                            (void *)((size_t)srcAddr + p->plan->size * j),
+                                            p->plan, cursor);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            cursor = reflectCloneFields(destAddr, srcAddr, p->plan, cursor);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            ObjList *list = *(ObjList **)srcAddr;
+            ObjList *nodes = (ObjList *)cursor;
+            size_t size = objListGetSize(list);
+            cursor += sizeof(ObjList) * size;
+            for (size_t j = 0; j < size; j++, list = list->next)
+            {
+                nodes[j].obj = NULL;
+                nodes[j].next = j + 1 < size ? &nodes[j + 1] : NULL;
+                if (list->obj)
+                {
+                    nodes[j].obj = cursor;
+                    memcpy(cursor, list->obj, p->plan->size);
+                    cursor = reflectCloneFields(cursor, list->obj, p->plan,
+                                                cursor + p->plan->alignedSize);
+                }
+            }
+            *(ObjList **)destAddr = size ? nodes : NULL;
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)srcAddr;
+            if (items)
+            {
+                size_t count = *(size_t *)((size_t)src + p->countOffset);
+                char *destItems = cursor;
+                *(char **)destAddr = memcpy(destItems, items, p->plan->size * count);
+                cursor += REFLECT_ALIGN(p->plan->size * count);
+                for (size_t j = 0; j < count && !p->plan->isPlain; j++)
+                {
+                    cursor = reflectCloneFields(destItems + p->plan->size * j,
+                                                items + p->plan->size * j, p->plan, cursor);
+                }
+            }
+        }
+    }
+    return cursor;
+}
+
+
+/**
+ * @brief 深度克隆对象
+ *        先计算整个对象图的大小，再将对象及其所有关联数据复制到一块连续的内存中
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return void* 克隆得到的对象，位于内存块起始处，内存不足返回NULL
+ * @note 使用 reflectFreeMem(obj) 一次释放所有数据，
+ *       不能使用 reflectFreeObj 释放，也不能修改对象的字符串，链表等字段
+ */
+void *reflectCloneObj(void *obj, Reflection *model)
+{
+    REFLECT_ASSERT(obj, return NULL);
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return NULL);
+    char *clone = REFLECT_MALLOC(plan->alignedSize + reflectCloneSize(obj, plan));
+    REFLECT_ASSERT(clone, return NULL);
+    memcpy(clone, obj, plan->size);
+    reflectCloneFields(clone, obj, plan, clone + plan->alignedSize);
+    return clone;
+}
+
+
+/**
+ * @brief 按字比较对象的指针类字段
+ * 
+ * @param a 对象a
+ * @param b 对象b
+ * @param plan 执行计划
+ * @return int 1 相等 0 不相等
+ */
+static int reflectEqualsFields(void *a, void *b, ReflectPlan *plan);
+
+
+/**
+ * @brief 比较对象
+ *        基本类型数据按合并后的区间整体比较，再比较指针类字段
+ * 
+ * @param a 对象a
+ * @param b 对象b
+ * @param plan 执行计划
+ * @return int 1 相等 0 不相等
+ */
+int reflectEqualsPlanObj(void *a, void *b, ReflectPlan *plan)
+{
+    if (a == b)
+    {
+        return 1;
+    }
+    if (!a || !b)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < plan->rangeCount; i++)
+    {
+        if (memcmp((char *)a + plan->ranges[i].offset,
+                   (char *)b + plan->ranges[i].offset,
+                   plan->ranges[i].size) != 0)
+        {
+            return 0;
+        }
+    }
+    return reflectEqualsFields(a, b, plan);
+}
+
+
+static int reflectEqualsFields(void *a, void *b, ReflectPlan *plan)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addrA = (void *)((size_t)a + p->offset);
+        void *addrB = (void *)((size_t)b + p->offset);
+        if (p->isPointer)
+        {
+            if (!reflectEqualsPlanObj(*(void **)addrA, *(void **)addrB, p->plan))
+            {
+                return 0;
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            char *strA = *(char **)addrA;
+            char *strB = *(char **)addrB;
+            if (strA != strB && (!strA || !strB || strcmp(strA, strB) != 0))
+            {
+                return 0;
+            }
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                if (!reflectEqualsFields((void *)((size_t)addrA + p->plan->size * j),
+                                         (void *)((size_t)addrB + p->plan->size * j),
+                                         p->plan))
+                {
+                    return 0;
+                }
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            if (!reflectEqualsFields(addrA, addrB, p->plan))
+            {
+                return 0;
+            }
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            ObjList *listA = *(ObjList **)addrA;
+            ObjList *listB = *(ObjList **)addrB;
+            while (listA && listB)
+            {
+                if (!reflectEqualsPlanObj(listA->obj, listB->obj, p->plan))
+                {
+                    return 0;
+                }
+                listA = listA->next;
+                listB = listB->next;
+            }
+            if (listA || listB)
+            {
+                return 0;
+            }
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            /* 元素数量为0或元素指针为NULL都是空动态数组，与 reflectHash 和序列化结果一致 */
+            char *itemsA = *(char **)addrA;
+            char *itemsB = *(char **)addrB;
+            size_t count = itemsA ? *(size_t *)((size_t)a + p->countOffset) : 0;
+            if (count != (itemsB ? *(size_t *)((size_t)b + p->countOffset) : 0))
+            {
+                return 0;
+            }
+            if (count == 0 || itemsA == itemsB)
+            {
+                continue;
+            }
+            if (p->plan->isPlain && p->plan->rangeCount == 1
+                && p->plan->ranges[0].size == p->plan->size)
+            {
+                /* 元素不含指针和对齐填充，整个动态数组一次比较 */
+                if (memcmp(itemsA, itemsB, p->plan->size * count) != 0)
+                {
+                    return 0;
+                }
+                continue;
+            }
+            for (size_t j = 0; j < count; j++)
+            {
+                if (!reflectEqualsPlanObj(itemsA + p->plan->size * j,
+                                          itemsB + p->plan->size * j, p->plan))
+                {
+                    return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+
+/**
+ * @brief 按模型比较对象是否相等
+ *        字符串比较内容，子对象和链表按模型递归比较，基本类型数据按位比较，对齐填充不参与比较
+ * 
+ * @param a 对象a
+ * @param b 对象b
+ * @param model Reflection 模型
+ * @return int 1 相等 0 不相等
+ */
+int reflectEquals(void *a, void *b, Reflection *model)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return 0);
+    return reflectEqualsPlanObj(a, b, plan);
+}
+
+
+#define REFLECT_HASH_PRIME      0x9e3779b97f4a7c15ULL
+
+/**
+ * @brief 数据哈希
+ *        按8字节一组处理，剩余部分逐字节处理
+ * 
+ * @param hash 当前哈希值
+ * @param data 数据
+ * @param size 数据大小
+ * @return uint64_t 哈希值
+ */
+static uint64_t reflectHashData(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    uint64_t word;
+    for (; size >= sizeof(word); p += sizeof(word), size -= sizeof(word))
+    {
+        memcpy(&word, p, sizeof(word));
+        hash = (hash ^ word) * REFLECT_HASH_PRIME;
+        hash ^= hash >> 29;
+    }
+    return reflectFnv(hash, p, size);
+}
+
+
+static uint64_t reflectHashFields(void *obj, ReflectPlan *plan, uint64_t hash);
+
+/**
+ * @brief 计算对象哈希
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param hash 当前哈希值
+ * @return uint64_t 哈希值
+ */
+static uint64_t reflectHashPlanObj(void *obj, ReflectPlan *plan, uint64_t hash)
+{
+    if (!obj)
+    {
+        return reflectFnv(hash, "", 1);
+    }
+    for (size_t i = 0; i < plan->rangeCount; i++)
+    {
+        hash = reflectHashData(hash, (char *)obj + plan->ranges[i].offset, plan->ranges[i].size);
+    }
+    return reflectHashFields(obj, plan, hash);
+}
+
+
+/**
+ * @brief 计算对象指针类字段的哈希
+ * 
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param hash 当前哈希值
+ * @return uint64_t 哈希值
+ */
+static uint64_t reflectHashFields(void *obj, ReflectPlan *plan, uint64_t hash)
+{
+    for (size_t i = 0; i < plan->fieldCount; i++)
+    {
+        ReflectPlanField *p = &plan->fields[i];
+        void *addr = (void *)((size_t)obj + p->offset);
+        if (p->isPointer)
+        {
+            hash = reflectHashPlanObj(*(void **)addr, p->plan, hash);
+        }
+        else if (p->type == REFLECT_TYPE_STRING)
+        {
+            char *str = *(char **)addr;
+            /* 包含结束符，NULL 与空字符串得到不同的哈希 */
+            hash = str ? reflectHashData(hash, str, strlen(str) + 1) : reflectFnv(hash, "", 1);
+        }
+        else if (p->type == REFLECT_TYPE_ARRAY)
+        {
+            for (size_t j = 0; j < p->count; j++)
+            {
+                hash = reflectHashFields((void *)((size_t)addr + p->plan->size * j), p->plan, hash);
+            }
+        }
+        else if (p->type == REFLECT_TYPE_STRUCT)
+        {
+            hash = reflectHashFields(addr, p->plan, hash);
+        }
+        else if (p->type == REFLECT_TYPE_LIST)
+        {
+            uint64_t size = 0;
+            for (ObjList *list = *(ObjList **)addr; list; list = list->next, size++)
+            {
+                hash = reflectHashPlanObj(list->obj, p->plan, hash);
+            }
+            hash = reflectFnv(hash, &size, sizeof(size));
+        }
+        else if (p->type == REFLECT_TYPE_VECTOR)
+        {
+            char *items = *(char **)addr;
+            uint64_t count = items ? *(size_t *)((size_t)obj + p->countOffset) : 0;
+            for (size_t j = 0; j < count; j++)
+            {
+                hash = reflectHashPlanObj(items + p->plan->size * j, p->plan, hash);
+            }
+            hash = reflectFnv(hash, &count, sizeof(count));
+        }
+    }
+    return hash;
+}
+
+
+/**
+ * @brief 按模型计算对象哈希
+ *        与 reflectEquals 一致，相等的对象得到相同的哈希值
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return uint64_t 哈希值
+ */
+uint64_t reflectHash(void *obj, Reflection *model)
+{
+    ReflectPlan *plan = reflectCompileModel(model);
+    REFLECT_ASSERT(plan, return 0);
+    uint64_t hash = reflectHashPlanObj(obj, plan, REFLECT_FNV_OFFSET);
+    hash ^= hash >> 33;
+    hash *= REFLECT_HASH_PRIME;
+    return hash ^ (hash >> 29);
+}
@@ -12,6 +12,7 @@
 #define __REFLECTION_H__
 
 #include "stddef.h"
+#include "stdint.h"
 #include "reflection_cfg.h"
 
 #define REFLECTION_VERSION              "1.0.0-beta1"
@@ -26,6 +27,9 @@
 #define REFLECT_ASSERT(x, expr) \
         if (!x) { expr; }
 
+#define REFLECT_FREE_SHARED             0x01        /**< 被多处引用的对象只释放一次 */
+#define REFLECT_FREE_KEEP_STRINGS       0x02        /**< 不释放字符串(字符串位于字符串池等外部内存中) */
+
 #define REFLECT_BASIC_MODEL_CHAR        &reflectBasicTypeModel[0]      /**< char型链表数据模型 */
 #define REFLECT_BASIC_MODEL_SHORT       &reflectBasicTypeModel[2]      /**< short型链表数据模型 */
 #define REFLECT_BASIC_MODEL_INT         &reflectBasicTypeModel[4]      /**< int型链表数据模型 */
@@ -215,6 +219,19 @@
 #define REFLECT_MODEL_LIST(type, key, model) \
         REFLECT_MODEL(0, REFLECT_TYPE_LIST, sizeof(void *), #key, offsetof(type, key), model)
 
+/**
+ * @brief Reflection 动态数组类型数据模型定义
+ *        元素连续存储在指针字段指向的内存中，元素数量由同一结构体中的 size_t 类型字段记录
+ * 
+ * @param type 对象(结构体)类型
+ * @param key 字段名(结构体成员名)，元素指针
+ * @param countKey 元素数量字段名(结构体成员名)，类型为 size_t
+ * @param model 元素 Reflection 模型
+ * @note 模型的 size 记录元素数量字段的偏移，元素数量为0或元素指针为NULL都表示空动态数组
+ */
+#define REFLECT_MODEL_VECTOR(type, key, countKey, model) \
+        REFLECT_MODEL(0, REFLECT_TYPE_VECTOR, offsetof(type, countKey), #key, offsetof(type, key), model)
+
 
 /**
  * @brief Reflection 数据类型
@@ -234,7 +251,8 @@ typedef enum
 
     REFLECT_TYPE_STRUCT,
     REFLECT_TYPE_ARRAY,
-    REFLECT_TYPE_LIST
+    REFLECT_TYPE_LIST,
+    REFLECT_TYPE_VECTOR
 } ReflectionType;
 
 /**
@@ -251,8 +269,112 @@ typedef struct reflection_def
     struct reflection_def *model;               /**< 子数据模型 */
 } Reflection;
 
+/**
+ * @brief Reflection 执行计划字段
+ *        只记录含有堆内存指针的字段，纯数据字段由对象整体复制处理
+ *
+ */
+typedef struct reflection_plan_field
+{
+    Reflection *field;                          /**< 原始模型字段 */
+    unsigned char isPointer;                    /**< 是否为指针类型数据 */
+    ReflectionType type;                        /**< 数据类型 */
+    size_t offset;                              /**< 偏移 */
+    size_t count;                               /**< 数组元素个数 */
+    size_t countOffset;                         /**< 动态数组元素数量字段偏移 */
+    struct reflection_plan *plan;               /**< 子数据模型执行计划 */
+    const char *key;                            /**< 字段键文本 ,"name": ，字段没有名称时为NULL */
+    size_t keyLen;                              /**< 字段键文本长度(含开头的逗号) */
+} ReflectPlanField;
+
+/**
+ * @brief Reflection 执行计划数据区间
+ *        对象中连续的基本类型数据，用于整体比较和哈希
+ *
+ */
+typedef struct
+{
+    size_t offset;                              /**< 偏移 */
+    size_t size;                                /**< 大小 */
+} ReflectPlanRange;
+
+/**
+ * @brief Reflection 执行计划
+ *        由 Reflection 模型编译得到，缓存对象大小和含指针字段，供各遍历操作使用
+ *
+ */
+typedef struct reflection_plan
+{
+    Reflection *model;                          /**< Reflection 模型 */
+    size_t size;                                /**< 对象大小 */
+    size_t alignedSize;                         /**< 按 size_t 对齐的对象大小 */
+    unsigned char isPlain;                      /**< 对象不包含堆内存指针 */
+    size_t fieldCount;                          /**< 含指针字段数量 */
+    ReflectPlanField *fields;                   /**< 含指针字段 */
+    size_t memberCount;                         /**< 字段数量 */
+    ReflectPlanField *members;                  /**< 所有字段(按模型顺序)，供逐字段编码的格式使用 */
+    Reflection **nameIndex;                     /**< 字段名哈希索引(开放寻址) */
+    size_t nameMask;                            /**< 字段名哈希索引掩码 */
+    size_t rangeCount;                          /**< 基本类型数据区间数量 */
+    ReflectPlanRange *ranges;                   /**< 基本类型数据区间(相邻字段合并，不含对齐填充) */
+} ReflectPlan;
+
+/**
+ * @brief 字段路径求值操作
+ * 
+ */
+typedef enum
+{
+    REFLECT_PATH_OP_NONE = 0,                   /**< 只累加偏移 */
+    REFLECT_PATH_OP_DEREF,                      /**< 累加偏移后解引用指针 */
+    REFLECT_PATH_OP_LIST,                       /**< 累加偏移后取链表元素 */
+    REFLECT_PATH_OP_VECTOR,                     /**< 累加偏移后取动态数组元素 */
+} ReflectPathOp;
+
+/**
+ * @brief 字段路径求值步骤
+ * 
+ */
+typedef struct
+{
+    size_t offset;                              /**< 累加的偏移 */
+    unsigned char op;                           /**< 求值操作 */
+    size_t index;                               /**< 链表，动态数组元素序号 */
+    size_t itemSize;                            /**< 动态数组元素大小 */
+    size_t countOffset;                         /**< 动态数组元素数量字段相对步骤起始的偏移 */
+} ReflectPathStep;
+
+/**
+ * @brief 编译的字段路径
+ * 
+ */
+typedef struct reflection_path
+{
+    Reflection *field;                          /**< 路径最后的字段模型 */
+    size_t stepCount;                           /**< 求值步骤数量 */
+    ReflectPathStep steps[];                    /**< 求值步骤 */
+} ReflectPath;
+
 extern Reflection reflectBasicTypeModel[];      /**< 基础类型链表数据模型 */
 
+/**
+ * @brief 按 size_t 对齐
+ *
+ * @param size 大小
+ */
+#define REFLECT_ALIGN(size) \
+        (((size) + sizeof(size_t) - 1) & (~(sizeof(size_t) - 1)))
+
+/**
+ * @brief 编译 Reflection 模型
+ *        模型及其子模型的执行计划只编译一次，之后直接从缓存获取
+ *
+ * @param model Reflection 模型
+ * @return ReflectPlan* 执行计划，内存不足返回NULL
+ * @note 多线程环境下需要配置 REFLECT_LOCK/REFLECT_UNLOCK
+ */
+ReflectPlan *reflectCompileModel(Reflection *model);
+
 /**
  * @brief 新字符串(字符串复制)
  * 
@@ -269,6 +391,172 @@ char *reflectNewString(char *str);
  */
 size_t reflectGetObjSize(Reflection *model);
 
+/**
+ * @brief 获取模型指纹
+ *        由模型及其子模型的字段类型，大小，偏移和名称计算得到，用于校验数据与模型是否匹配
+ * 
+ * @param model Reflection 模型
+ * @return uint64_t 模型指纹
+ */
+uint64_t reflectGetModelFingerprint(Reflection *model);
+
+/**
+ * @brief 在执行计划的字段名索引中查找字段
+ * 
+ * @param plan 执行计划
+ * @param name 字段名，不需要以'\0'结束
+ * @param len 字段名长度
+ * @return Reflection* 字段模型，未找到返回NULL
+ */
+Reflection *reflectPlanFindField(ReflectPlan *plan, const char *name, size_t len);
+
+/**
+ * @brief 按字段名查找字段
+ *        通过执行计划中的字段名哈希索引查找，索引在模型编译时建立
+ * 
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @return Reflection* 字段模型，未找到返回NULL
+ */
+Reflection *reflectFindField(Reflection *model, const char *name);
+
+/**
+ * @brief 按字段名获取整数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 char，short，int 或 long
+ * @return long 字段值，字段不存在或类型不匹配时返回0
+ */
+long reflectGetInt(void *obj, Reflection *model, const char *name);
+
+/**
+ * @brief 按字段名设置整数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 char，short，int 或 long
+ * @param value 字段值，按字段类型截断
+ * @return int 0 成功 -1 字段不存在或类型不匹配
+ */
+int reflectSetInt(void *obj, Reflection *model, const char *name, long value);
+
+/**
+ * @brief 按字段名获取浮点数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 float 或 double
+ * @return double 字段值，字段不存在或类型不匹配时返回0
+ */
+double reflectGetDouble(void *obj, Reflection *model, const char *name);
+
+/**
+ * @brief 按字段名设置浮点数字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名，字段类型为 float 或 double
+ * @param value 字段值
+ * @return int 0 成功 -1 字段不存在或类型不匹配
+ */
+int reflectSetDouble(void *obj, Reflection *model, const char *name, double value);
+
+/**
+ * @brief 按字段名获取字符串字段
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @return char* 字符串，字段不存在或类型不匹配时返回NULL
+ */
+char *reflectGetString(void *obj, Reflection *model, const char *name);
+
+/**
+ * @brief 按字段名设置字符串字段
+ *        字符串被复制，原字符串被释放，与 reflectFreeObj 的内存管理一致
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param name 字段名
+ * @param value 字符串，可为NULL
+ * @return int 0 成功 -1 字段不存在，类型不匹配或内存不足
+ */
+int reflectSetString(void *obj, Reflection *model, const char *name, const char *value);
+
+/**
+ * @brief 编译字段路径
+ *        路径由'.'分隔的字段名组成，数组，链表和动态数组字段可以使用[n]指定元素，例如 "sub.sub[1].a"，
+ *        编译时解析字段名并合并连续的偏移，求值时只需要按步骤累加偏移和解引用
+ * 
+ * @param model Reflection 模型
+ * @param path 字段路径
+ * @return ReflectPath* 编译得到的路径，路径无效或内存不足返回NULL
+ * @note 使用 reflectFreePath 释放
+ */
+ReflectPath *reflectCompilePath(Reflection *model, const char *path);
+
+/**
+ * @brief 按编译的路径获取字段地址
+ * 
+ * @param path 编译得到的路径
+ * @param obj 对象
+ * @return void* 字段(或数组，链表元素)地址，路径中的指针为NULL或者链表，动态数组元素不存在时返回NULL
+ * @note 字段类型由 path->field 确定，指定了元素序号时为元素地址，链表元素按序号遍历
+ */
+void *reflectPathGet(ReflectPath *path, void *obj);
+
+/**
+ * @brief 释放编译的字段路径
+ * 
+ * @param path 编译得到的路径
+ */
+#define reflectFreePath(path) \
+        REFLECT_FREE(path)
+
+/**
+ * @brief 深度克隆对象
+ *        先计算整个对象图的大小，再将对象及其所有关联数据复制到一块连续的内存中
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return void* 克隆得到的对象，位于内存块起始处，内存不足返回NULL
+ * @note 使用 reflectFreeMem(obj) 一次释放所有数据，
+ *       不能使用 reflectFreeObj 释放，也不能修改对象的字符串，链表等字段
+ */
+void *reflectCloneObj(void *obj, Reflection *model);
+
+/**
+ * @brief 按模型比较对象是否相等
+ *        字符串比较内容，子对象和链表按模型递归比较，基本类型数据按位比较，对齐填充不参与比较
+ * 
+ * @param a 对象a
+ * @param b 对象b
+ * @param model Reflection 模型
+ * @return int 1 相等 0 不相等
+ */
+int reflectEquals(void *a, void *b, Reflection *model);
+
+/**
+ * @brief 按执行计划比较对象是否相等
+ *
+ * @param a 对象a
+ * @param b 对象b
+ * @param plan 执行计划
+ * @return int 1 相等 0 不相等
+ */
+int reflectEqualsPlanObj(void *a, void *b, ReflectPlan *plan);
+
+/**
+ * @brief 按模型计算对象哈希
+ *        与 reflectEquals 一致，相等的对象得到相同的哈希值
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @return uint64_t 哈希值
+ */
+uint64_t reflectHash(void *obj, Reflection *model);
+
 /**
  * @brief 释放对象内存
  * 
@@ -278,6 +566,24 @@ size_t reflectGetObjSize(Reflection *model);
  */
 void reflectFreeObjEx(void *obj, Reflection *model, char isPointer);
 
+/**
+ * @brief 按执行计划释放对象内存
+ *
+ * @param obj 对象
+ * @param plan 执行计划
+ * @param isPointer 是否为指针类型
+ */
+void reflectFreePlanObj(void *obj, ReflectPlan *plan, char isPointer);
+
+/**
+ * @brief 按选项释放对象内存
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ * @param options 释放选项，REFLECT_FREE_SHARED，REFLECT_FREE_KEEP_STRINGS 的组合
+ */
+void reflectFreeObjOpt(void *obj, Reflection *model, int options);
+
 /**
  * @brief 释放对象内存
  * 
@@ -287,6 +593,16 @@ void reflectFreeObjEx(void *obj, Reflection *model, char isPointer);
 #define reflectFreeObj(obj, model) \
         reflectFreeObjEx(obj, model, 1)
 
+/**
+ * @brief 释放共享引用的对象内存
+ *        被多处引用的子对象和链表对象只释放一次，对象之间可以存在循环引用
+ * 
+ * @param obj 对象
+ * @param model Reflection 模型
+ */
+#define reflectFreeShared(obj, model) \
+        reflectFreeObjOpt(obj, model, REFLECT_FREE_SHARED)
+
 /**
  * @brief 释放内存
  * 
@@ -299,4 +615,7 @@ void reflectFreeObjEx(void *obj, Reflection *model, char isPointer);
  * @}
  */
 
+#include "reflect_alloc.h"
+#include "reflect_stats.h"
+
 #endif
@@ -13,14 +13,176 @@
 
 #include "stdlib.h"
 
+/**
+ * @brief 用户配置文件
+ *        定义 REFLECT_CFG_USER_FILE 时先包含该文件，文件中定义的配置覆盖以下默认配置，
+ *        例如编译时传入 -DREFLECT_CFG_USER_FILE=\"my_reflection_cfg.h\"
+ */
+#ifdef REFLECT_CFG_USER_FILE
+#include REFLECT_CFG_USER_FILE
+#endif
+
 /**
  * @brief 内存分配函数
  */
+#ifndef REFLECT_MALLOC
 #define REFLECT_MALLOC          malloc
+#endif
 
 /**
  * @brief 内存释放函数
  */
+#ifndef REFLECT_FREE
 #define REFLECT_FREE            free
+#endif
+
+/**
+ * @brief 全局数据加锁
+ *        执行计划缓存等全局数据在首次使用时创建，多线程环境下需要配置为互斥锁操作
+ */
+#ifndef REFLECT_LOCK
+#define REFLECT_LOCK()
+#endif
+
+/**
+ * @brief 全局数据解锁
+ */
+#ifndef REFLECT_UNLOCK
+#define REFLECT_UNLOCK()
+#endif
+
+/**
+ * @brief 执行计划无锁查找表的容量(2的幂)
+ *        编译完成的执行计划发布到查找表，获取已缓存的计划不需要 REFLECT_LOCK，
+ *        查找表已满时回退到加锁查找，配置为 0 时关闭无锁查找
+ */
+#ifndef REFLECT_PLAN_PUBLISH_SIZE
+#define REFLECT_PLAN_PUBLISH_SIZE   256
+#endif
+
+/**
+ * @brief 执行计划无锁查找的读取(acquire)和发布(release)
+ *        GCC 和 Clang 下默认使用 __atomic 内建函数，其他编译器需要自行配置，未配置时关闭无锁查找
+ */
+#if !defined(REFLECT_LOAD_ACQUIRE) && (defined(__GNUC__) || defined(__clang__))
+#define REFLECT_LOAD_ACQUIRE(ptr)           __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define REFLECT_STORE_RELEASE(ptr, value)   __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#endif
+
+/**
+ * @brief 线程局部存储声明
+ *        多线程环境下可以配置为 _Thread_local 或 __thread，使节点池等数据每个线程独立
+ */
+#ifndef REFLECT_THREAD_LOCAL
+#define REFLECT_THREAD_LOCAL
+#endif
+
+/**
+ * @brief 对象链表节点池使能
+ *        使能后链表节点从连续的内存块中分配，释放的节点通过空闲链表回收，
+ *        加入链表的节点(包括 objListAddNode，objListHeadAddNode)都必须由 objListNodeAlloc 分配
+ */
+#ifndef OBJ_LIST_POOL_ENABLE
+#define OBJ_LIST_POOL_ENABLE        0
+#endif
+
+/**
+ * @brief 对象链表节点池每个内存块的节点数量
+ */
+#ifndef OBJ_LIST_POOL_CHUNK_SIZE
+#define OBJ_LIST_POOL_CHUNK_SIZE    256
+#endif
+
+/**
+ * @brief 对象链表节点池加锁
+ *        节点在分配节点的线程之外释放时加锁，默认使用 REFLECT_LOCK
+ */
+#ifndef OBJ_LIST_POOL_LOCK
+#define OBJ_LIST_POOL_LOCK()        REFLECT_LOCK()
+#endif
+
+/**
+ * @brief 对象链表节点池解锁
+ */
+#ifndef OBJ_LIST_POOL_UNLOCK
+#define OBJ_LIST_POOL_UNLOCK()      REFLECT_UNLOCK()
+#endif
+
+/**
+ * @brief 字符串池每个内存块的大小
+ */
+#ifndef STR_POOL_CHUNK_SIZE
+#define STR_POOL_CHUNK_SIZE         4096
+#endif
+
+/**
+ * @brief 线程缓存分配器每次从系统分配的内存块大小
+ */
+#ifndef REFLECT_CACHE_CHUNK_SIZE
+#define REFLECT_CACHE_CHUNK_SIZE    65536
+#endif
+
+/**
+ * @brief 线程缓存分配器和仓库之间每批交换的空闲内存块数量
+ */
+#ifndef REFLECT_CACHE_BATCH
+#define REFLECT_CACHE_BATCH         32
+#endif
+
+/**
+ * @brief 线程缓存分配器仓库加锁
+ *        多个线程的缓存共享仓库时需要配置为互斥锁操作，不能与 REFLECT_LOCK 使用同一个非递归锁
+ */
+#ifndef REFLECT_CACHE_LOCK
+#define REFLECT_CACHE_LOCK()
+#endif
+
+/**
+ * @brief 线程缓存分配器仓库解锁
+ */
+#ifndef REFLECT_CACHE_UNLOCK
+#define REFLECT_CACHE_UNLOCK()
+#endif
+
+/**
+ * @brief 运行统计使能
+ *        使能后统计序列化，反序列化，释放和 JSON 编解码的调用次数，数据大小，内存分配和耗时，
+ *        REFLECT_MALLOC 和 REFLECT_FREE 经过统计函数调用，多线程环境下需要配置 REFLECT_THREAD_LOCAL
+ */
+#ifndef REFLECT_STATS_ENABLE
+#define REFLECT_STATS_ENABLE        0
+#endif
+
+/**
+ * @brief 运行统计计数读取
+ *        统计分片只由所属线程写入，快照在其他线程读取，默认使用 relaxed 原子操作，
+ *        编译器不支持 __atomic 内建函数时为普通读写，多线程环境下快照中的计数为近似值
+ */
+#ifndef REFLECT_STATS_LOAD
+#if defined(__GNUC__) || defined(__clang__)
+#define REFLECT_STATS_LOAD(ptr)             __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#else
+#define REFLECT_STATS_LOAD(ptr)             (*(ptr))
+#endif
+#endif
+
+/**
+ * @brief 运行统计计数写入
+ */
+#ifndef REFLECT_STATS_STORE
+#if defined(__GNUC__) || defined(__clang__)
+#define REFLECT_STATS_STORE(ptr, value)     __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#else
+#define REFLECT_STATS_STORE(ptr, value)     (*(ptr) = (value))
+#endif
+#endif
+
+/**
+ * @brief 运行统计计时函数
+ *        返回单调递增的纳秒时间，默认使用 clock_gettime，配置为 0 时不统计耗时
+ */
+#ifndef REFLECT_STATS_CLOCK
+#define REFLECT_STATS_CLOCK()       reflectStatsClock()
+#endif
 
 #endif
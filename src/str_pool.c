@@ -0,0 +1,175 @@
+/**
+ * @file str_pool.c
+ * @author agent
+ * @brief string pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "reflection.h"
+#include "str_pool.h"
+#include "string.h"
+
+#define STR_POOL_MIN_CAPACITY   16
+
+
+/**
+ * @brief 字符串哈希(FNV-1a)
+ *
+ * @param str 字符串，不需要以'\0'结束
+ * @param len 字符串长度
+ * @return size_t 哈希值
+ */
+size_t strPoolHash(const char *str, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return (size_t)hash;
+}
+
+
+/**
+ * @brief 字符串池哈希表扩容
+ *
+ * @param pool 字符串池
+ * @param capacity 新容量
+ * @return int 0 成功 -1 内存不足
+ */
+static int strPoolResize(StrPool *pool, size_t capacity)
+{
+    const char **entries = REFLECT_MALLOC(sizeof(const char *) * capacity);
+    REFLECT_ASSERT(entries, return -1);
+    memset(entries, 0, sizeof(const char *) * capacity);
+
+    for (size_t i = 0; i < pool->capacity; i++)
+    {
+        if (pool->entries[i])
+        {
+            size_t index = strPoolHash(pool->entries[i], strlen(pool->entries[i])) & (capacity - 1);
+            while (entries[index])
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+            entries[index] = pool->entries[i];
+        }
+    }
+
+    if (pool->entries)
+    {
+        REFLECT_FREE(pool->entries);
+    }
+    pool->entries = entries;
+    pool->capacity = capacity;
+    return 0;
+}
+
+
+/**
+ * @brief 从字符串池内存块分配空间
+ *        超过内存块一半大小的字符串单独分配内存块
+ *
+ * @param pool 字符串池
+ * @param size 大小
+ * @return char* 分配得到的空间，内存不足返回NULL
+ */
+static char *strPoolAlloc(StrPool *pool, size_t size)
+{
+    if (size > STR_POOL_CHUNK_SIZE / 2)
+    {
+        StrPoolChunk *chunk = REFLECT_MALLOC(sizeof(StrPoolChunk) + size);
+        REFLECT_ASSERT(chunk, return NULL);
+        /* 单独的内存块放在当前内存块之后，不影响当前内存块的剩余空间 */
+        if (pool->chunks)
+        {
+            chunk->next = pool->chunks->next;
+            pool->chunks->next = chunk;
+        }
+        else
+        {
+            chunk->next = NULL;
+            pool->chunks = chunk;
+            pool->free = 0;
+        }
+        return (char *)(chunk + 1);
+    }
+
+    if (size > pool->free)
+    {
+        StrPoolChunk *chunk = REFLECT_MALLOC(sizeof(StrPoolChunk) + STR_POOL_CHUNK_SIZE);
+        REFLECT_ASSERT(chunk, return NULL);
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->free = STR_POOL_CHUNK_SIZE;
+    }
+    char *mem = (char *)(pool->chunks + 1) + STR_POOL_CHUNK_SIZE - pool->free;
+    pool->free -= size;
+    return mem;
+}
+
+
+/**
+ * @brief 字符串驻留
+ *        返回池中与 str 内容相同的字符串，不存在时复制到池中
+ *
+ * @param pool 字符串池
+ * @param str 字符串
+ * @return const char* 池中的字符串(只读)，内存不足返回NULL
+ */
+const char *strPoolIntern(StrPool *pool, const char *str)
+{
+    if ((pool->size + 1) * 4 > pool->capacity * 3)
+    {
+        if (strPoolResize(pool, pool->capacity ? pool->capacity * 2 : STR_POOL_MIN_CAPACITY) != 0)
+        {
+            return NULL;
+        }
+    }
+
+    size_t len = strlen(str);
+    size_t index = strPoolHash(str, len) & (pool->capacity - 1);
+    while (pool->entries[index])
+    {
+        if (strcmp(pool->entries[index], str) == 0)
+        {
+            return pool->entries[index];
+        }
+        index = (index + 1) & (pool->capacity - 1);
+    }
+
+    char *dest = strPoolAlloc(pool, len + 1);
+    REFLECT_ASSERT(dest, return NULL);
+    memcpy(dest, str, len + 1);
+    pool->entries[index] = dest;
+    pool->size++;
+    return dest;
+}
+
+
+/**
+ * @brief 清空字符串池，释放所有字符串
+ *
+ * @param pool 字符串池
+ */
+void strPoolClear(StrPool *pool)
+{
+    while (pool->chunks)
+    {
+        StrPoolChunk *chunk = pool->chunks;
+        pool->chunks = chunk->next;
+        REFLECT_FREE(chunk);
+    }
+    if (pool->entries)
+    {
+        REFLECT_FREE(pool->entries);
+    }
+    pool->entries = NULL;
+    pool->capacity = 0;
+    pool->size = 0;
+    pool->free = 0;
+}
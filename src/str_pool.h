@@ -0,0 +1,77 @@
+/**
+ * @file str_pool.h
+ * @author agent
+ * @brief string pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#ifndef __STR_POOL_H__
+#define __STR_POOL_H__
+
+#include "stddef.h"
+
+/**
+ * @defgroup STR_POOL string_pool
+ * @brief string pool
+ * @addtogroup STR_POOL
+ * @{
+ */
+
+/**
+ * @brief 字符串池内存块
+ *
+ */
+typedef struct str_pool_chunk
+{
+    struct str_pool_chunk *next;                /**< 下一个内存块 */
+} StrPoolChunk;
+
+/**
+ * @brief 字符串池
+ *        相同内容的字符串只保存一份，字符串连续存放在内存块中，池释放前一直有效
+ *
+ * @note 零初始化的 StrPool 即为空池，可以直接使用，字符串池不是线程安全的
+ */
+typedef struct
+{
+    const char **entries;                       /**< 字符串哈希表 */
+    size_t capacity;                            /**< 哈希表容量(2的幂) */
+    size_t size;                                /**< 字符串数量 */
+    StrPoolChunk *chunks;                       /**< 内存块 */
+    size_t free;                                /**< 当前内存块剩余大小 */
+} StrPool;
+
+/**
+ * @brief 字符串哈希
+ *
+ * @param str 字符串，不需要以'\0'结束
+ * @param len 字符串长度
+ * @return size_t 哈希值
+ */
+size_t strPoolHash(const char *str, size_t len);
+
+/**
+ * @brief 字符串驻留
+ *        返回池中与 str 内容相同的字符串，不存在时复制到池中
+ *
+ * @param pool 字符串池
+ * @param str 字符串
+ * @return const char* 池中的字符串(只读)，内存不足返回NULL
+ */
+const char *strPoolIntern(StrPool *pool, const char *str);
+
+/**
+ * @brief 清空字符串池，释放所有字符串
+ *
+ * @param pool 字符串池
+ */
+void strPoolClear(StrPool *pool);
+
+/**
+ * @}
+ */
+
+#endif
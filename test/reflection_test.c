@@ -0,0 +1,581 @@
+/**
+ * @file reflection_test.c
+ * @author agent
+ * @brief c reflection regression test
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright (c) 2026 agent
+ *
+ */
+#include "reflection.h"
+#include "obj_list.h"
+#include "cerializable.h"
+#include "cjsonable.h"
+#include "stdio.h"
+#include "string.h"
+
+
+#define TEST_LIST_SIZE              2048        /**< 链表元素数量，不少于 CERIAL_PARALLEL_MIN_ITEMS 以触发并行序列化，多于 CERIAL_STREAM_SIZE_CACHE 以覆盖大小记录的替换 */
+#define TEST_VECTOR_SIZE            16          /**< 动态数组元素数量 */
+#define TEST_STREAM_WINDOW          64          /**< 流式序列化窗口大小，小于对象大小以覆盖分段输出 */
+
+/**
+ * @brief 检查条件，失败时输出位置并返回失败
+ */
+#define TEST_CHECK(expr) \
+        do { \
+            if (!(expr)) \
+            { \
+                printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+                return -1; \
+            } \
+        } while (0)
+
+
+/**
+ * @brief 链表和动态数组元素
+ *
+ */
+typedef struct
+{
+    int id;
+    char *name;
+} TestItem;
+
+Reflection testItemReflection[] =
+{
+    REFLECT_MODEL_INT(TestItem, id),
+    REFLECT_MODEL_STRING(TestItem, name),
+    REFLECT_MODEL_OBJ(TestItem),
+};
+
+/**
+ * @brief 覆盖所有字段类型的对象
+ *
+ */
+typedef struct test_node
+{
+    int value;
+    char *label;
+    double weight;
+    int codes[4];
+    TestItem *items;
+    size_t itemCount;
+    ObjList *list;
+    struct test_node *next;
+} TestNode;
+
+Reflection testNodeReflection[] =
+{
+    REFLECT_MODEL_INT(TestNode, value),
+    REFLECT_MODEL_STRING(TestNode, label),
+    REFLECT_MODEL_DOUBLE(TestNode, weight),
+    REFLECT_MODEL_ARRAY(TestNode, codes, 4, REFLECT_BASIC_MODEL_INT),
+    REFLECT_MODEL_VECTOR(TestNode, items, itemCount, testItemReflection),
+    REFLECT_MODEL_LIST(TestNode, list, testItemReflection),
+    REFLECT_MODEL_STRUCT_P(TestNode, next, testNodeReflection),
+    REFLECT_MODEL_OBJ(TestNode),
+};
+
+/**
+ * @brief 互相引用的模型，A 内嵌 B，B 通过指针引用 A
+ *
+ */
+typedef struct test_mutual_a TestMutualA;
+
+typedef struct
+{
+    TestMutualA *a;
+} TestMutualB;
+
+struct test_mutual_a
+{
+    TestMutualB b;
+    int value;
+};
+
+extern Reflection testMutualAReflection[];
+
+Reflection testMutualBReflection[] =
+{
+    REFLECT_MODEL_STRUCT_P(TestMutualB, a, testMutualAReflection),
+    REFLECT_MODEL_OBJ(TestMutualB),
+};
+
+Reflection testMutualAReflection[] =
+{
+    REFLECT_MODEL_STRUCT(TestMutualA, b, sizeof(TestMutualB), testMutualBReflection),
+    REFLECT_MODEL_INT(TestMutualA, value),
+    REFLECT_MODEL_OBJ(TestMutualA),
+};
+
+/**
+ * @brief 测试用例
+ *
+ */
+typedef struct
+{
+    const char *name;
+    int (*run)(void);
+} TestCase;
+
+/**
+ * @brief 流式序列化输出缓冲
+ *
+ */
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+} TestSink;
+
+
+/**
+ * @brief 创建链表元素
+ *
+ * @param id 编号
+ * @return TestItem* 元素
+ */
+static TestItem *testNewItem(int id)
+{
+    char name[32];
+    TestItem *item = REFLECT_MALLOC(sizeof(TestItem));
+    sprintf(name, "item-%d", id);
+    item->id = id;
+    item->name = reflectNewString(name);
+    return item;
+}
+
+
+/**
+ * @brief 创建测试对象
+ *
+ * @param value 对象值
+ * @param listSize 链表元素数量
+ * @param depth next 链的长度
+ * @return TestNode* 对象
+ */
+static TestNode *testNewNode(int value, size_t listSize, size_t depth)
+{
+    TestNode *node = REFLECT_MALLOC(sizeof(TestNode));
+    memset(node, 0, sizeof(TestNode));
+    node->value = value;
+    node->label = value % 3 ? reflectNewString("node \"label\"\n") : NULL;
+    node->weight = value * 0.25;
+    for (int i = 0; i < 4; i++)
+    {
+        node->codes[i] = value * 4 + i;
+    }
+    node->itemCount = TEST_VECTOR_SIZE;
+    node->items = REFLECT_MALLOC(sizeof(TestItem) * TEST_VECTOR_SIZE);
+    for (size_t i = 0; i < TEST_VECTOR_SIZE; i++)
+    {
+        node->items[i].id = (int)i;
+        node->items[i].name = i % 2 ? reflectNewString("vector") : NULL;
+    }
+    ObjListHead list = {0};
+    for (size_t i = 0; i < listSize; i++)
+    {
+        objListHeadAdd(&list, testNewItem(value + (int)i));
+    }
+    node->list = list.head;
+    node->next = depth > 1 ? testNewNode(value + 1, listSize / 2, depth - 1) : NULL;
+    return node;
+}
+
+
+/**
+ * @brief 流式序列化写函数
+ *
+ * @param context 输出缓冲
+ * @param data 数据
+ * @param size 数据大小
+ * @return int 0 成功 -1 内存不足
+ */
+static int testSinkWrite(void *context, const void *data, size_t size)
+{
+    TestSink *sink = context;
+    if (sink->size + size > sink->capacity)
+    {
+        size_t capacity = (sink->size + size) * 2;
+        char *buffer = REFLECT_MALLOC(capacity);
+        if (!buffer)
+        {
+            return -1;
+        }
+        if (sink->data)
+        {
+            memcpy(buffer, sink->data, sink->size);
+            REFLECT_FREE(sink->data);
+        }
+        sink->data = buffer;
+        sink->capacity = capacity;
+    }
+    memcpy(sink->data + sink->size, data, size);
+    sink->size += size;
+    return 0;
+}
+
+
+/**
+ * @brief 流式和并行序列化的输出与 cSerialize 逐字节一致
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testStreamIdentity(void)
+{
+    TestNode *node = testNewNode(1, TEST_LIST_SIZE, 3);
+    size_t size = 0;
+    void *mem = cSerialize(node, testNodeReflection, &size);
+    TEST_CHECK(mem && size);
+
+    TestSink sink = {0};
+    size_t streamSize = 0;
+    TEST_CHECK(cSerializeStream(node, testNodeReflection, testSinkWrite, &sink,
+                                TEST_STREAM_WINDOW, &streamSize) == CERIAL_OK);
+    TEST_CHECK(streamSize == size && sink.size == size);
+    TEST_CHECK(memcmp(sink.data, mem, size) == 0);
+
+    size_t parallelSize = 0;
+    void *parallel = cSerializeParallel(node, testNodeReflection, &parallelSize, 4);
+    TEST_CHECK(parallel && parallelSize == size);
+    TEST_CHECK(memcmp(parallel, mem, size) == 0);
+
+    TestNode *copy = cDeserialize(mem, testNodeReflection);
+    TEST_CHECK(copy && reflectEquals(node, copy, testNodeReflection));
+
+    reflectFreeObj(copy, testNodeReflection);
+    reflectFreeMem(parallel);
+    REFLECT_FREE(sink.data);
+    reflectFreeMem(mem);
+    reflectFreeObj(node, testNodeReflection);
+    return 0;
+}
+
+
+/**
+ * @brief 紧凑格式往返
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testCompactRoundTrip(void)
+{
+    TestNode *node = testNewNode(2, 64, 3);
+    CSerialBuffer buffer = {0};
+    TEST_CHECK(cSerializeCompact(node, testNodeReflection, &buffer) == CERIAL_OK);
+
+    size_t used = 0;
+    TestNode *copy = cDeserializeCompact(buffer.mem, buffer.used, testNodeReflection, &used);
+    TEST_CHECK(copy && used == buffer.used);
+    TEST_CHECK(reflectEquals(node, copy, testNodeReflection));
+    /* 截断的数据解码失败 */
+    TEST_CHECK(cDeserializeCompact(buffer.mem, buffer.used / 2, testNodeReflection, NULL) == NULL);
+
+    reflectFreeObj(copy, testNodeReflection);
+    cSerialBufferFree(&buffer);
+    reflectFreeObj(node, testNodeReflection);
+    return 0;
+}
+
+
+/**
+ * @brief 增量序列化后应用到旧对象的副本，得到与新对象相等的对象
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testDeltaRoundTrip(void)
+{
+    TestNode *oldNode = testNewNode(4, 32, 2);
+    TestNode *newNode = testNewNode(4, 32, 2);
+    newNode->value = 40;
+    REFLECT_FREE(newNode->label);
+    newNode->label = reflectNewString("changed");
+    newNode->codes[2] = -1;
+    newNode->items[3].id = 300;
+    ((TestItem *)newNode->list->next->obj)->id = 500;
+    newNode->list = objListAdd(newNode->list, testNewItem(1000));
+    newNode->next->value = 50;
+
+    size_t size = 0;
+    void *mem = cSerialize(oldNode, testNodeReflection, &size);
+    TestNode *peer = cDeserialize(mem, testNodeReflection);
+    TEST_CHECK(peer);
+
+    CSerialBuffer delta = {0};
+    TEST_CHECK(cSerializeDelta(oldNode, newNode, testNodeReflection, &delta) == CERIAL_OK);
+    size_t used = 0;
+    TEST_CHECK(cApplyDelta(peer, delta.mem, delta.used, testNodeReflection, &used) == CERIAL_OK);
+    TEST_CHECK(used == delta.used);
+    TEST_CHECK(reflectEquals(peer, newNode, testNodeReflection));
+
+    cSerialBufferFree(&delta);
+    reflectFreeObj(peer, testNodeReflection);
+    reflectFreeMem(mem);
+    reflectFreeObj(newNode, testNodeReflection);
+    reflectFreeObj(oldNode, testNodeReflection);
+    return 0;
+}
+
+
+/**
+ * @brief JSON 编解码往返
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testJsonRoundTrip(void)
+{
+    TestNode *node = testNewNode(5, 64, 3);
+    /* 链表中的空元素编码为 null 并解码回空元素 */
+    node->list = objListAdd(node->list, NULL);
+    size_t len = 0;
+    char *json = cJsonStringify(node, testNodeReflection, &len);
+    TEST_CHECK(json && len == strlen(json));
+
+    size_t used = 0;
+    TestNode *copy = cJsonDecode(json, len, testNodeReflection, &used);
+    TEST_CHECK(copy && used == len);
+    TEST_CHECK(reflectEquals(node, copy, testNodeReflection));
+
+    /* 重新编码得到相同的文本 */
+    size_t copyLen = 0;
+    char *copyJson = cJsonStringify(copy, testNodeReflection, &copyLen);
+    TEST_CHECK(copyJson && copyLen == len && memcmp(copyJson, json, len) == 0);
+
+    REFLECT_FREE(copyJson);
+    reflectFreeObj(copy, testNodeReflection);
+    REFLECT_FREE(json);
+    reflectFreeObj(node, testNodeReflection);
+    return 0;
+}
+
+
+/**
+ * @brief 共享引用和循环引用的序列化
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testSharedCycle(void)
+{
+    TestNode *a = testNewNode(7, 4, 1);
+    TestNode *b = testNewNode(8, 4, 1);
+    a->next = b;
+    b->next = a;
+    /* 同一个元素在链表中出现两次 */
+    a->list = objListAdd(a->list, a->list->obj);
+
+    size_t size = 0;
+    void *mem = cSerializeShared(a, testNodeReflection, &size);
+    TEST_CHECK(mem && size);
+    TestNode *copy = cDeserializeShared(mem, testNodeReflection);
+    TEST_CHECK(copy && copy != a);
+    TEST_CHECK(copy->next && copy->next != copy && copy->next->next == copy);
+    TEST_CHECK(copy->value == 7 && copy->next->value == 8);
+
+    ObjList *last = copy->list;
+    while (last->next)
+    {
+        last = last->next;
+    }
+    TEST_CHECK(last->obj == copy->list->obj);
+
+    reflectFreeShared(copy, testNodeReflection);
+    reflectFreeMem(mem);
+    /* 原对象的循环和重复元素需要手动断开后释放 */
+    b->next = NULL;
+    last = a->list;
+    while (last->next->next)
+    {
+        last = last->next;
+    }
+    objListNodeFree(last->next);
+    last->next = NULL;
+    reflectFreeObj(a, testNodeReflection);
+    return 0;
+}
+
+
+/**
+ * @brief 互相引用的模型编译执行计划并序列化
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testMutualRecursion(void)
+{
+    ReflectPlan *planB = reflectCompileModel(testMutualBReflection);
+    ReflectPlan *planA = reflectCompileModel(testMutualAReflection);
+    TEST_CHECK(planA && planB);
+    TEST_CHECK(!planA->isPlain && !planB->isPlain && planA->fieldCount == 1);
+
+    TestMutualA *inner = REFLECT_MALLOC(sizeof(TestMutualA));
+    memset(inner, 0, sizeof(TestMutualA));
+    inner->value = 7;
+    TestMutualA *outer = REFLECT_MALLOC(sizeof(TestMutualA));
+    memset(outer, 0, sizeof(TestMutualA));
+    outer->value = 3;
+    outer->b.a = inner;
+
+    size_t size = 0;
+    void *mem = cSerialize(outer, testMutualAReflection, &size);
+    TEST_CHECK(mem && size == 2 * REFLECT_ALIGN(sizeof(TestMutualA)));
+    TestMutualA *copy = cDeserialize(mem, testMutualAReflection);
+    TEST_CHECK(copy && copy->b.a && copy->b.a != inner && copy->b.a->value == 7);
+    TEST_CHECK(reflectEquals(outer, copy, testMutualAReflection));
+
+    reflectFreeObj(copy, testMutualAReflection);
+    reflectFreeMem(mem);
+    reflectFreeObj(outer, testMutualAReflection);
+    return 0;
+}
+
+
+/**
+ * @brief 元素数量为0但已分配内存的动态数组与空动态数组等价
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testZeroCountVector(void)
+{
+    TestNode node = {0};
+    node.items = REFLECT_MALLOC(sizeof(TestItem));
+    node.itemCount = 0;
+    TestNode empty = {0};
+
+    TEST_CHECK(reflectEquals(&node, &empty, testNodeReflection));
+    TEST_CHECK(reflectHash(&node, testNodeReflection) == reflectHash(&empty, testNodeReflection));
+
+    size_t size = 0;
+    void *mem = cSerialize(&node, testNodeReflection, &size);
+    TEST_CHECK(mem);
+    TestNode *copy = cDeserialize(mem, testNodeReflection);
+    TEST_CHECK(copy && copy->itemCount == 0);
+    TEST_CHECK(reflectEquals(&node, copy, testNodeReflection));
+
+    size_t len = 0;
+    char *json = cJsonStringify(&node, testNodeReflection, &len);
+    TEST_CHECK(json);
+    TestNode *decoded = cJsonDecode(json, len, testNodeReflection, NULL);
+    TEST_CHECK(decoded && decoded->itemCount == 0);
+
+    reflectFreeObj(decoded, testNodeReflection);
+    REFLECT_FREE(json);
+    reflectFreeObj(copy, testNodeReflection);
+    reflectFreeMem(mem);
+    REFLECT_FREE(node.items);
+    return 0;
+}
+
+
+/**
+ * @brief 分段输入数据进行流式反序列化
+ *
+ * @param mem 序列化数据
+ * @param size 数据大小
+ * @param result 反序列化结果
+ * @return TestNode* 反序列化得到的对象，失败返回NULL
+ */
+static TestNode *testStreamFeed(const char *mem, size_t size, int *result)
+{
+    CDeserialStream stream;
+    size_t offset = 0;
+    *result = cDeserialStreamInit(&stream, testNodeReflection);
+    while (*result == CERIAL_PENDING && offset < size)
+    {
+        size_t used = 0;
+        size_t len = size - offset < 7 ? size - offset : 7;
+        *result = cDeserialStreamFeed(&stream, mem + offset, len, &used);
+        offset += used;
+    }
+    if (*result == CERIAL_OK && offset != size)
+    {
+        *result = CERIAL_ERROR_INVALID;
+    }
+    return cDeserialStreamFinish(&stream);
+}
+
+
+/**
+ * @brief 字符串表数据的流式反序列化，共享引用的数据作为无效数据处理
+ *
+ * @return int 0 通过 -1 失败
+ */
+static int testStringTableStream(void)
+{
+    TestNode *node = testNewNode(1, TEST_LIST_SIZE, 3);
+    size_t plainSize = 0;
+    void *plain = cSerialize(node, testNodeReflection, &plainSize);
+    size_t size = 0;
+    void *mem = cSerializeEx(node, testNodeReflection, &size, CERIAL_OPTION_STRING_TABLE);
+    TEST_CHECK(plain && mem && size < plainSize);
+
+    int result = 0;
+    TestNode *copy = testStreamFeed(mem, size, &result);
+    TEST_CHECK(result == CERIAL_OK && copy);
+    TEST_CHECK(reflectEquals(node, copy, testNodeReflection));
+    /* 重复的字符串反序列化为独立的副本 */
+    TEST_CHECK(copy->items[1].name != copy->items[3].name);
+    reflectFreeObj(copy, testNodeReflection);
+
+    TestNode *a = testNewNode(7, 4, 1);
+    a->next = testNewNode(8, 4, 1);
+    a->next->next = a;
+    size_t sharedSize = 0;
+    void *shared = cSerializeShared(a, testNodeReflection, &sharedSize);
+    TEST_CHECK(shared);
+    TEST_CHECK(testStreamFeed(shared, sharedSize, &result) == NULL);
+    TEST_CHECK(result == CERIAL_ERROR_INVALID);
+
+    a->next->next = NULL;
+    reflectFreeObj(a, testNodeReflection);
+    reflectFreeMem(shared);
+    reflectFreeMem(mem);
+    reflectFreeMem(plain);
+    reflectFreeObj(node, testNodeReflection);
+    return 0;
+}
+
+
+static TestCase testCases[] =
+{
+    {"stream_identity", testStreamIdentity},
+    {"compact_round_trip", testCompactRoundTrip},
+    {"delta_round_trip", testDeltaRoundTrip},
+    {"json_round_trip", testJsonRoundTrip},
+    {"shared_cycle", testSharedCycle},
+    {"mutual_recursion", testMutualRecursion},
+    {"zero_count_vector", testZeroCountVector},
+    {"string_table_stream", testStringTableStream},
+};
+
+
+/**
+ * @brief 运行测试用例
+ *        不带参数时运行所有用例，否则只运行指定名称的用例
+ *
+ * @param argc 参数数量
+ * @param argv 参数
+ * @return int 0 全部通过 1 有用例失败
+ */
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    int matched = 0;
+    for (size_t i = 0; i < sizeof(testCases) / sizeof(testCases[0]); i++)
+    {
+        if (argc > 1 && strcmp(argv[1], testCases[i].name) != 0)
+        {
+            continue;
+        }
+        matched++;
+        int result = testCases[i].run();
+        printf("%-24s %s\n", testCases[i].name, result == 0 ? "ok" : "FAILED");
+        failed += result != 0;
+    }
+    if (!matched)
+    {
+        printf("unknown test: %s\n", argv[1]);
+        return 1;
+    }
+    return failed ? 1 : 0;
+}